@@ -1,4 +1,5 @@
 #!/usr/bin/env python
+# cf. timingApp/src/mpsSelfTest.cpp for an in-IOC test of many nodes concurrently
 
 import argparse
 import epics
@@ -0,0 +1,110 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <string.h>
+#include <math.h>
+
+#include <testMain.h>
+#include <alarm.h>
+#include <epicsThread.h>
+#include <epicsStdio.h>
+#include <epicsMonotonic.h>
+#include <dbAccess.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+#include <aiRecord.h>
+
+extern
+int testBitTable_registerRecordDeviceDriver(struct dbBase *);
+
+/* device clock runs 1000 seconds ahead of host monotonic clock */
+static const double offset = POSIX_TIME_AT_EPICS_EPOCH + 1000.0;
+
+static
+double hostNow(void)
+{
+    return epicsMonotonicGet()*1e-9;
+}
+
+static
+double testProcVal(const char *pv)
+{
+    aiRecord *prec = (aiRecord*)testdbRecordPtr(pv);
+    char proc[64];
+    double ret;
+    epicsSnprintf(proc, sizeof(proc), "%s.PROC", pv);
+    testdbPutFieldOk(proc, DBF_LONG, 0);
+    dbScanLock((dbCommon*)prec);
+    ret = prec->val;
+    dbScanUnlock((dbCommon*)prec);
+    return ret;
+}
+
+MAIN(testClockModel)
+{
+    unsigned i;
+    double val, expect;
+
+    testPlan(25);
+
+    testdbPrepare();
+    testdbReadDatabase("testBitTable.dbd", NULL, NULL);
+    testBitTable_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("testClockModel.db", NULL, "P=TST:");
+    testIocInitOk();
+
+    testDiag("Sample");
+    for(i=0u; i<5u; i++) {
+        testdbPutFieldOk("TST:sample", DBF_DOUBLE, hostNow() + offset);
+        epicsThreadSleep(0.01);
+    }
+    val = testProcVal("TST:n");
+    testOk(val==5.0, "n %f == 5", val);
+
+    val = testProcVal("TST:rate");
+    testOk(fabs(val-1.0) < 1e-2, "rate %f ~= 1", val);
+
+    expect = hostNow() + offset;
+    val = testProcVal("TST:now");
+    testOk(fabs(val-expect) < 1e-3, "now %f ~= %f", val, expect);
+
+    val = testProcVal("TST:err");
+    testOk(val>=0.0 && val < 1e-3, "err %g < 1e-3", val);
+
+    testDiag("Sample relative to epoch=");
+    for(i=0u; i<5u; i++) {
+        testdbPutFieldOk("TST:sample2", DBF_DOUBLE, hostNow() + offset - POSIX_TIME_AT_EPICS_EPOCH);
+        epicsThreadSleep(0.01);
+    }
+    expect = hostNow() + offset;
+    val = testProcVal("TST:now2");
+    testOk(fabs(val-expect) < 1e-3, "now %f ~= %f", val, expect);
+
+    testDiag("Receive PPS ahead of model");
+    {
+        /* 0.5 sec ahead of now */
+        double pps = hostNow() + offset + 0.5;
+        epicsUInt32 evtlog[3];
+        evtlog[0] = 125;
+        evtlog[1] = (epicsUInt32)pps;
+        evtlog[2] = (epicsUInt32)((pps - evtlog[1])*1e9); /* ticks, 1 ns/tick */
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+
+    expect = hostNow() + offset + 0.5;
+    val = testProcVal("TST:now");
+    testOk(fabs(val-expect) < 1e-2, "now %f ~= %f", val, expect);
+
+    val = testProcVal("TST:lag");
+    testOk(fabs(val+0.5) < 1e-2, "lag %f ~= -0.5", val);
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
@@ -0,0 +1,87 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <string.h>
+
+#include <testMain.h>
+#include <alarm.h>
+#include <iocsh.h>
+#include <epicsEvent.h>
+#include <callback.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+
+extern
+int testBitTable_registerRecordDeviceDriver(struct dbBase *);
+
+MAIN(testCoincidence)
+{
+    testPlan(14);
+
+    testdbPrepare();
+    testdbReadDatabase("testBitTable.dbd", NULL, NULL);
+    testBitTable_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("testCoincidence.db", NULL, "P=TST:");
+    testIocInitOk();
+
+    testDiag("Push matches and misses");
+    {
+        const epicsUInt32 evtlog[] = {
+            10,631152010,100, 20,631152010,130, // match 30 ns
+            20,631152010,200,                   // B w/o A
+            10,631152010,300, 10,631152010,310, // A again before B
+            20,631152010,500,                   // A expired, then B w/o A
+            10,631152010,600, 20,631152010,700, // match 100 ns
+        };
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    testdbGetFieldEqual("TST:match", DBF_LONG, 2);
+    testdbGetFieldEqual("TST:missA", DBF_LONG, 2);
+    testdbGetFieldEqual("TST:missB", DBF_LONG, 2);
+    testdbGetFieldEqual("TST:delay", DBF_LONG, 100);
+    {
+        const epicsUInt32 hist[] = {0, 1, 0, 1};
+        testdbGetArrFieldEqual("TST:hist", DBF_ULONG, 4, NELEMENTS(hist), hist);
+    }
+    {
+        dbCommon *prec = testdbRecordPtr("TST:match");
+        epicsTimeStamp ts;
+        dbScanLock(prec);
+        ts = prec->time;
+        dbScanUnlock(prec);
+        testOk(ts.secPastEpoch==10 && ts.nsec==700,
+               "TST:match.TIME (%u, %u) == 10, 700", ts.secPastEpoch, ts.nsec);
+    }
+
+    testDiag("Reset");
+    testdbPutFieldOk("TST:reset", DBF_LONG, 1);
+    testSyncCallback();
+    testdbGetFieldEqual("TST:match", DBF_LONG, 0);
+    testdbGetFieldEqual("TST:missB", DBF_LONG, 0);
+
+    testDiag("B out of order, before the armed A");
+    {
+        const epicsUInt32 evtlog[] = {
+            10,631152011,1000, 20,631152011,990, // B w/o A
+            20,631152011,1050,                   // match 50 ns
+        };
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    testdbGetFieldEqual("TST:match", DBF_LONG, 1);
+    testdbGetFieldEqual("TST:missA", DBF_LONG, 0);
+    testdbGetFieldEqual("TST:missB", DBF_LONG, 1);
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
@@ -0,0 +1,68 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <string.h>
+
+#include <testMain.h>
+#include <alarm.h>
+#include <iocsh.h>
+#include <epicsEvent.h>
+#include <callback.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+
+extern
+int testBitTable_registerRecordDeviceDriver(struct dbBase *);
+
+MAIN(testDbEvent)
+{
+    testPlan(7);
+
+    testdbPrepare();
+    testdbReadDatabase("testBitTable.dbd", NULL, NULL);
+    testBitTable_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("testDbEvent.db", NULL, "P=TST:");
+    testIocInitOk();
+
+    testDiag("Only codes selected by dbevent= are posted");
+    {
+        const epicsUInt32 evtlog[] = {10,631152010,100, 11,631152010,200, 12,631152010,300};
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    testdbGetFieldEqual("TST:cnt10", DBF_LONG, 1);
+    testdbGetFieldEqual("TST:cnt11", DBF_LONG, 1);
+    testdbGetFieldEqual("TST:cnt12", DBF_LONG, 0);
+
+    testDiag("Fan-out latency");
+    {
+        DBADDR addr;
+        double lat = -1.0;
+        long nReq = 1;
+        if(dbNameToAddr("TST:lat10", &addr))
+            testAbort("No TST:lat10");
+        dbScanLock(addr.precord);
+        (void)dbGetField(&addr, DBR_DOUBLE, &lat, NULL, &nReq, NULL);
+        dbScanUnlock(addr.precord);
+        testOk(lat>=0.0 && lat<1.0, "latency %g sec", lat);
+    }
+
+    {
+        const epicsUInt32 evtlog[] = {10,631152011,100};
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    testdbGetFieldEqual("TST:cnt10", DBF_LONG, 2);
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
@@ -0,0 +1,103 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <string.h>
+
+#include <testMain.h>
+#include <alarm.h>
+#include <iocsh.h>
+#include <epicsEvent.h>
+#include <callback.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+
+extern
+int testBitTable_registerRecordDeviceDriver(struct dbBase *);
+
+static
+int testTIMEeq(const char *pv, epicsUInt32 sec, epicsUInt32 nsec)
+{
+    dbCommon * prec = testdbRecordPtr(pv);
+    epicsTimeStamp ts;
+    dbScanLock(prec);
+    ts = prec->time;
+    dbScanUnlock(prec);
+
+    return testOk(ts.secPastEpoch==sec && ts.nsec==nsec,
+                  "%s.TIME (%u, %u) == %u, %u",
+                  prec->name,
+                  ts.secPastEpoch, ts.nsec,
+                  sec, nsec);
+}
+
+MAIN(testEventDecim)
+{
+    testPlan(11);
+
+    testdbPrepare();
+    testdbReadDatabase("testBitTable.dbd", NULL, NULL);
+    testBitTable_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("testEventDecim.db", NULL, "P=TST:");
+    testIocInitOk();
+
+    {
+        const epicsUInt32 evtlog[] = {
+            1,631152010,100, 2,631152010,110, 3,631152010,120,
+            1,631152010,200, 2,631152010,210, 3,631152010,220,
+            1,631152010,300, 2,631152010,310, 3,631152010,320,
+            1,631152010,400, 2,631152010,410,
+            1,631152010,500, 2,631152010,510,
+            2,631152010,610, 3,631152010,1120, // new period
+            2,631152010,710, 3,631152010,1220,
+            3,631152010,1320,
+            4,631152010,100, 4,631152010,200, 4,631152010,300,
+            5,631152010,100, 5,631152010,200, 5,631152010,300,
+        };
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+
+    testDiag("overflow=oldest keeps the newest");
+    {
+        const epicsUInt32 ns[] = {300, 400, 500};
+        testdbGetArrFieldEqual("TST:buf1", DBF_ULONG, 3, NELEMENTS(ns), ns);
+    }
+    testdbGetFieldEqual("TST:oflow1", DBF_LONG, 2);
+
+    testDiag("every=3");
+    {
+        const epicsUInt32 ns[] = {310, 610};
+        testdbGetArrFieldEqual("TST:buf2", DBF_ULONG, 8, NELEMENTS(ns), ns);
+    }
+    testdbGetFieldEqual("TST:decim2", DBF_LONG, 5);
+
+    testDiag("limit=2 period=1000");
+    {
+        const epicsUInt32 ns[] = {120, 220, 1120, 1220};
+        testdbGetArrFieldEqual("TST:buf3", DBF_ULONG, 8, NELEMENTS(ns), ns);
+    }
+    testdbGetFieldEqual("TST:decim3", DBF_LONG, 2);
+    testdbGetFieldEqual("TST:oflow3", DBF_LONG, 0);
+
+    testDiag("overflow=oldest with NELM=1");
+    {
+        const epicsUInt32 ns[] = {300};
+        testdbGetArrFieldEqual("TST:buf4", DBF_ULONG, 1, NELEMENTS(ns), ns);
+    }
+    testTIMEeq("TST:buf4", 10, 300); // time of the one kept
+
+    testDiag("DOUBLE and columnar buffers count one overflow per event");
+    testdbGetFieldEqual("TST:oflow5", DBF_LONG, 1);
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
@@ -0,0 +1,88 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <string.h>
+
+#include <testMain.h>
+#include <alarm.h>
+#include <iocsh.h>
+#include <epicsEvent.h>
+#include <callback.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+#include <epicsStdio.h>
+
+extern
+int testBitTable_registerRecordDeviceDriver(struct dbBase *);
+
+static
+void testStat(const char *pv, epicsInt32 expect)
+{
+    char proc[64];
+    epicsSnprintf(proc, sizeof(proc), "%s.PROC", pv);
+    testdbPutFieldOk(proc, DBF_LONG, 0);
+    testdbGetFieldEqual(pv, DBF_LONG, expect);
+}
+
+MAIN(testEventMerge)
+{
+    testPlan(17);
+
+    testdbPrepare();
+    testdbReadDatabase("testBitTable.dbd", NULL, NULL);
+    testBitTable_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("testEventMerge.db", NULL, "P=TST:");
+    testIocInitOk();
+
+    testdbPutFieldOk("TST:code", DBF_LONG, 10);
+
+    testDiag("Interleave two sources");
+    {
+        const epicsUInt32 evtlog[] = {10,631152010,100, 10,631152010,300, 10,631152010,500};
+        testdbPutArrFieldOk("TST:inputA", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    {
+        const epicsUInt32 evtlog[] = {10,631152010,200, 10,631152010,400};
+        testdbPutArrFieldOk("TST:inputB", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    {
+        // 500 held until B passes it, or it ages out of the reorder window
+        const epicsUInt32 ns[] = {100, 200, 300, 400};
+        testdbGetArrFieldEqual("TST:buf", DBF_ULONG, 16, NELEMENTS(ns), ns);
+    }
+    testStat("TST:held", 1);
+    testStat("TST:reordered", 2);
+
+    testDiag("Late arrival is dropped");
+    {
+        const epicsUInt32 evtlog[] = {10,631152010,250};
+        testdbPutArrFieldOk("TST:inputB", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testStat("TST:late", 1);
+
+    testDiag("Age out of reorder window");
+    {
+        const epicsUInt32 evtlog[] = {10,631152010,3000};
+        testdbPutArrFieldOk("TST:inputA", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    {
+        const epicsUInt32 ns[] = {500};
+        testdbGetArrFieldEqual("TST:buf", DBF_ULONG, 16, NELEMENTS(ns), ns);
+    }
+    testStat("TST:maxHeld", 5);
+    testStat("TST:held", 1);
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
@@ -0,0 +1,158 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <string.h>
+
+#include <pvxs/client.h>
+#include <pvxs/server.h>
+#include <pvxs/iochooks.h>
+
+#include <testMain.h>
+#include <iocsh.h>
+#include <epicsEvent.h>
+#include <epicsThread.h>
+#include <dbAccess.h>
+#include <dbUnitTest.h>
+
+extern "C"
+int testEventPva_registerRecordDeviceDriver(struct dbBase *);
+
+namespace {
+using namespace pvxs;
+
+double readStat(const char *pv)
+{
+    DBADDR addr;
+    double val = -1.0;
+    long nReq = 1;
+
+    if(dbNameToAddr(pv, &addr))
+        testAbort("No %s", pv);
+
+    dbScanLock(addr.precord);
+    (void)dbProcess(addr.precord);
+    (void)dbGetField(&addr, DBR_DOUBLE, &val, NULL, &nReq, NULL);
+    dbScanUnlock(addr.precord);
+    return val;
+}
+
+void testStat(const char *pv, double expect)
+{
+    double val = readStat(pv);
+    testOk(val==expect, "%s (%g) == %g", pv, val, expect);
+}
+
+// next update, or empty after timeout
+Value popWait(client::Subscription& sub, epicsEvent& ready, double timeout=5.0)
+{
+    for(double t=0.0; t<timeout; t+=0.1) {
+        if(auto val = sub.pop())
+            return val;
+        ready.wait(0.1);
+    }
+    return Value();
+}
+
+void push(const epicsUInt32 *evtlog, size_t n)
+{
+    testdbPutArrFieldOk("TST:input", DBF_ULONG, n, evtlog);
+}
+
+} // namespace
+
+MAIN(testEventPva)
+{
+    testPlan(23);
+
+    ioc::testPrepare();
+    testdbReadDatabase("testEventPva.dbd", NULL, NULL);
+    testEventPva_registerRecordDeviceDriver(pdbbase);
+
+    testOk1(iocshCmd("eventPvaStream TST:STREAM TST:LOG \"1,2\" 2 64")==0);
+
+    testdbReadDatabase("testEventPva.db", NULL, "P=TST:");
+    testIocInitOk();
+    {
+        auto cli(ioc::server().clientConfig().build());
+        epicsEvent ready;
+
+        auto sub(cli.monitor("TST:STREAM")
+                 .record("pipeline", true)
+                 .record("queueSize", 4)
+                 .maskConnected(true)
+                 .maskDisconnected(true)
+                 .event([&ready](client::Subscription&) { ready.trigger(); })
+                 .exec());
+
+        testDiag("Initial update is empty");
+        auto val(popWait(*sub, ready));
+        testOk(val && val["value.code"].as<shared_array<const uint8_t>>().empty(),
+               "initial %s", val ? "update" : "timeout");
+
+        testStat("TST:subscribers", 1.0);
+
+        testDiag("Push, code 3 filtered");
+        {
+            const epicsUInt32 evtlog[] = {1,631152012,1, 3,631152012,2, 2,631152013,0};
+            push(evtlog, NELEMENTS(evtlog));
+        }
+
+        val = popWait(*sub, ready);
+        if(val) {
+            auto code(val["value.code"].as<shared_array<const uint8_t>>());
+            auto sec(val["value.sec"].as<shared_array<const uint32_t>>());
+            auto ns(val["value.ns"].as<shared_array<const uint32_t>>());
+            testOk(code.size()==2u && code[0]==1u && code[1]==2u,
+                   "codes %u", unsigned(code.size()));
+            testOk(sec.size()==2u && sec[0]==631152012u && sec[1]==631152013u
+                   && ns.size()==2u && ns[0]==1u && ns[1]==0u, "sec/ns");
+            testOk(val["seq"].as<uint64_t>()==1u, "seq %u", val["seq"].as<unsigned>());
+        } else {
+            testFail("timeout");
+            testSkip(2, "timeout");
+        }
+
+        testDiag("Slow subscriber misses batches, ingest does not stall");
+        for(epicsUInt32 i=0u; i<10u; i++) {
+            const epicsUInt32 evtlog[] = {1,631152014,i};
+            push(evtlog, NELEMENTS(evtlog));
+            epicsThreadSleep(0.05);
+        }
+        epicsThreadSleep(0.1);
+
+        testStat("TST:events", 12.0);
+        testStat("TST:batches", 11.0);
+        {
+            double squashed = readStat("TST:squashed");
+            testOk(squashed>0.0, "squashed %g", squashed);
+        }
+
+        uint64_t prev = 1u;
+        unsigned nrx = 0u;
+        bool increasing = true;
+        while(auto val = popWait(*sub, ready, 1.0)) {
+            auto seq(val["seq"].as<uint64_t>());
+            increasing &= seq > prev;
+            prev = seq;
+            nrx++;
+        }
+        testOk(increasing && nrx<10u, "%u of 10 updates, last seq %u", nrx, unsigned(prev));
+
+        testDiag("Resumes once drained");
+        {
+            const epicsUInt32 evtlog[] = {2,631152015,0};
+            push(evtlog, NELEMENTS(evtlog));
+        }
+        val = popWait(*sub, ready);
+        testOk(val && val["seq"].as<uint64_t>()==12u, "seq %u", val ? val["seq"].as<unsigned>() : 0u);
+    }
+
+    testIocShutdownOk();
+    ioc::testShutdown();
+
+    return testDone();
+}
@@ -0,0 +1,132 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <string.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <testMain.h>
+#include <alarm.h>
+#include <iocsh.h>
+#include <dbAccess.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+
+#include "eventShm.h"
+
+extern
+int testBitTable_registerRecordDeviceDriver(struct dbBase *);
+
+MAIN(testEventShm)
+{
+    eventShmReader *reader;
+    eventShmRecord recs[16];
+    uint64_t nLost = 0u;
+    int n;
+
+    testPlan(20);
+
+    testdbPrepare();
+    testdbReadDatabase("testBitTable.dbd", NULL, NULL);
+    testBitTable_registerRecordDeviceDriver(pdbbase);
+
+    testOk1(iocshCmd("eventShmExport TST:LOG /testEventShm 8 \"100,101\"")==0);
+
+    testdbReadDatabase("testEventShm.db", NULL, "P=TST:");
+    testIocInitOk();
+
+    reader = eventShmOpen("/testEventShm");
+    if(!reader)
+        testAbort("Unable to open /testEventShm");
+
+    testDiag("Writer restart replaces the ring");
+    testOk1(iocshCmd("eventShmExport TST:LOG /testEventShm 8 \"100,101\"")==0);
+    testOk1(eventShmRead(reader, recs, NELEMENTS(recs), &nLost)==-1);
+    eventShmClose(reader);
+
+    reader = eventShmOpen("/testEventShm");
+    if(!reader)
+        testAbort("Unable to re-open /testEventShm");
+
+    testOk1(eventShmHead(reader)==0u);
+    testOk1(eventShmRead(reader, recs, NELEMENTS(recs), &nLost)==0);
+
+    testDiag("Push, 102 not exported");
+    {
+        const epicsUInt32 evtlog[] = {100,631152012,1, 102,631152012,2, 101,631152013,0};
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+
+    n = eventShmRead(reader, recs, NELEMENTS(recs), &nLost);
+    testOk(n==2, "read %d", n);
+    testOk(recs[0].code==100 && recs[0].seq==1u, "code %u seq %u",
+           recs[0].code, (unsigned)recs[0].seq);
+    testOk(recs[1].code==101 && recs[1].seq==2u, "code %u seq %u",
+           recs[1].code, (unsigned)recs[1].seq);
+    testOk(recs[1].sec==recs[0].sec+1u, "sec %u %u", recs[0].sec, recs[1].sec);
+    testOk1(nLost==0u);
+
+    testDiag("Overrun capacity");
+    {
+        epicsUInt32 evtlog[3*12];
+        unsigned i;
+        for(i=0u; i<12u; i++) {
+            evtlog[3*i+0] = 100;
+            evtlog[3*i+1] = 631152014;
+            evtlog[3*i+2] = i;
+        }
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+
+    testOk1(eventShmHead(reader)==14u);
+    n = eventShmRead(reader, recs, NELEMENTS(recs), &nLost);
+    testOk(n==8, "read %d", n);
+    testOk(nLost==4u, "lost %u", (unsigned)nLost);
+    testOk(n>0 && recs[0].seq==7u && recs[n-1].seq==14u, "seq %u -> %u",
+           n>0 ? (unsigned)recs[0].seq : 0u, n>0 ? (unsigned)recs[n-1].seq : 0u);
+
+    testDiag("Record left mid-write by the writer is counted lost");
+    {
+        const epicsUInt32 evtlog[] = {100,631152015,0, 101,631152015,1};
+        size_t len = sizeof(eventShmHeader) + 8u*sizeof(eventShmRecord);
+        int fd = shm_open("/testEventShm", O_RDWR, 0);
+        char *base;
+        eventShmRecord *slot;
+
+        if(fd<0)
+            testAbort("Unable to open /testEventShm for writing");
+        base = mmap(NULL, len, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if(base==MAP_FAILED)
+            testAbort("Unable to map /testEventShm");
+
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+
+        /* as if the writer stopped after clearing seq of record 15 */
+        slot = &((eventShmRecord*)(base + sizeof(eventShmHeader)))[15u & 7u];
+        __atomic_store_n(&slot->seq, 0u, __ATOMIC_RELEASE);
+        munmap(base, len);
+    }
+
+    nLost = 0u;
+    n = eventShmRead(reader, recs, NELEMENTS(recs), &nLost);
+    testOk(n==1 && recs[0].seq==16u && recs[0].code==101, "read %d seq %u",
+           n, n>0 ? (unsigned)recs[0].seq : 0u);
+    testOk(nLost==1u, "lost %u", (unsigned)nLost);
+    testOk1(eventShmRead(reader, recs, NELEMENTS(recs), &nLost)==0);
+
+    eventShmClose(reader);
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    shm_unlink("/testEventShm");
+
+    return testDone();
+}
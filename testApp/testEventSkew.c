@@ -0,0 +1,97 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <string.h>
+
+#include <testMain.h>
+#include <alarm.h>
+#include <iocsh.h>
+#include <epicsEvent.h>
+#include <callback.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+
+extern
+int testBitTable_registerRecordDeviceDriver(struct dbBase *);
+
+MAIN(testEventSkew)
+{
+    testPlan(14);
+
+    testdbPrepare();
+    testdbReadDatabase("testBitTable.dbd", NULL, NULL);
+    testBitTable_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("testEventSkew.db", NULL, "P=TST:");
+    testIocInitOk();
+
+    testDiag("Instance seen by all nodes, other codes ignored");
+    {
+        const epicsUInt32 evtlog[] = {10, 631152010, 1000, 11, 631152010, 1050};
+        testdbPutArrFieldOk("TST:n0", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    {
+        const epicsUInt32 evtlog[] = {10, 631152010, 1100};
+        testdbPutArrFieldOk("TST:n1", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    {
+        const epicsUInt32 evtlog[] = {10, 631152010, 900};
+        testdbPutArrFieldOk("TST:n2", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    {
+        const double mean[] = {0.0, 100.0, -100.0};
+        testdbGetArrFieldEqual("TST:mean", DBF_DOUBLE, 3, NELEMENTS(mean), mean);
+    }
+    {
+        const double count[] = {1.0, 1.0, 1.0};
+        testdbGetArrFieldEqual("TST:count", DBF_DOUBLE, 3, NELEMENTS(count), count);
+    }
+    testdbGetFieldEqual("TST:last1", DBF_DOUBLE, 100.0);
+
+    testDiag("Instance missed by node 2, abandoned after hold=");
+    {
+        const epicsUInt32 evtlog[] = {10, 631152011, 1000};
+        testdbPutArrFieldOk("TST:n0", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    {
+        const epicsUInt32 evtlog[] = {10, 631152011, 1300};
+        testdbPutArrFieldOk("TST:n1", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    {
+        const epicsUInt32 evtlog[] = {10, 631152012, 0};
+        testdbPutArrFieldOk("TST:n0", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    {
+        const double mean[] = {0.0, 200.0, -100.0};
+        testdbGetArrFieldEqual("TST:mean", DBF_DOUBLE, 3, NELEMENTS(mean), mean);
+    }
+    {
+        const double count[] = {2.0, 2.0, 1.0};
+        testdbGetArrFieldEqual("TST:count", DBF_DOUBLE, 3, NELEMENTS(count), count);
+    }
+    {
+        const double missed[] = {0.0, 0.0, 1.0};
+        testdbGetArrFieldEqual("TST:missed", DBF_DOUBLE, 3, NELEMENTS(missed), missed);
+    }
+
+    testDiag("Reset");
+    testdbPutFieldOk("TST:reset", DBF_LONG, 1);
+    testSyncCallback();
+    {
+        const double count[] = {0.0, 0.0, 0.0};
+        testdbGetArrFieldEqual("TST:count", DBF_DOUBLE, 3, NELEMENTS(count), count);
+    }
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
@@ -6,6 +6,7 @@
 #define USE_TYPED_RSET
 
 #include <string.h>
+#include <math.h>
 
 #include <testMain.h>
 #include <alarm.h>
@@ -16,6 +17,7 @@
 #include <dbScan.h>
 #include <dbStaticLib.h>
 #include <dbUnitTest.h>
+#include <aiRecord.h>
 
 extern
 int testBitTable_registerRecordDeviceDriver(struct dbBase *);
@@ -36,9 +38,23 @@ int testTIMEeq(const char *pv, epicsUInt32 sec, epicsUInt32 nsec)
                   sec, nsec);
 }
 
+static
+int testVALnear(const char *pv, double expect, double tol)
+{
+    dbCommon * prec = testdbRecordPtr(pv);
+    double val;
+    dbScanLock(prec);
+    val = ((aiRecord*)prec)->val;
+    dbScanUnlock(prec);
+
+    return testOk(fabs(val-expect) <= tol,
+                  "%s.VAL %f ~= %f",
+                  prec->name, val, expect);
+}
+
 MAIN(testEventTable)
 {
-    testPlan(23);
+    testPlan(74);
 
     testdbPrepare();
     testdbReadDatabase("testBitTable.dbd", NULL, NULL);
@@ -64,6 +80,9 @@ MAIN(testEventTable)
 
     testdbPutFieldOk("TST:code1", DBF_LONG, 100);
     testdbPutFieldOk("TST:code2", DBF_LONG, 25);
+    testdbPutFieldOk("TST:gcode1", DBF_LONG, 100);
+    testdbPutFieldOk("TST:gcode2", DBF_LONG, 25);
+    testdbPutFieldOk("TST:capcode", DBF_LONG, 50);
 
     testDiag("Push uninteresting");
     {
@@ -92,6 +111,27 @@ MAIN(testEventTable)
         testdbGetArrFieldEqual("TST:buf1", DBF_DOUBLE, 5, NELEMENTS(dlt), dlt);
     }
 
+    testTIMEeq("TST:buf2abs", 12, 1*2); // time of first in buffer
+    {
+        const epicsInt64 abs[] = {631152012000000002ll, 631152012000000008ll};
+        const epicsUInt32 sec[] = {631152012, 631152012};
+        const epicsUInt32 ns[] = {1*2, 4*2};
+        testdbGetArrFieldEqual("TST:buf2abs", DBF_INT64, 16, NELEMENTS(abs), abs);
+        testdbGetArrFieldEqual("TST:buf2sec", DBF_ULONG, 16, NELEMENTS(sec), sec);
+        testdbGetArrFieldEqual("TST:buf2ns", DBF_ULONG, 16, NELEMENTS(ns), ns);
+    }
+
+    testDiag("Group snapshot");
+    testdbGetFieldEqual("TST:gepoch", DBF_LONG, 3);
+    {
+        const double dlt[] = {0, 2e-9};
+        const epicsInt64 abs[] = {631152012000000002ll, 631152012000000008ll};
+        testdbGetArrFieldEqual("TST:gbuf1", DBF_DOUBLE, 16, NELEMENTS(dlt), dlt);
+        testdbGetArrFieldEqual("TST:gbuf2", DBF_INT64, 16, NELEMENTS(abs), abs);
+    }
+    testdbGetFieldEqual("TST:gbuf1.UTAG", DBF_LONG, 3);
+    testdbGetFieldEqual("TST:gbuf2.UTAG", DBF_LONG, 3);
+
     testDiag("Push only 25");
     {
         const epicsUInt32 evtlog[] = {25,631152012,8};
@@ -100,6 +140,105 @@ MAIN(testEventTable)
     testSyncCallback();
     testdbGetFieldEqual("TST:last1", DBF_LONG, 2);
     testdbGetFieldEqual("TST:last2", DBF_LONG, 3);
+    {
+        const epicsInt64 abs[] = {631152012000000016ll};
+        testdbGetArrFieldEqual("TST:buf2abs", DBF_INT64, 16, NELEMENTS(abs), abs);
+        testdbGetArrFieldEqual("TST:gbuf2", DBF_INT64, 16, NELEMENTS(abs), abs);
+    }
+    testdbGetFieldEqual("TST:gepoch", DBF_LONG, 4);
+    testdbGetFieldEqual("TST:gbuf1.NORD", DBF_LONG, 0);
+
+    testDiag("Capture around 50");
+    {
+        const epicsUInt32 evtlog[] = {50,631152013,10, 7,631152013,11, 8,631152013,12};
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    testdbGetFieldEqual("TST:capcnt", DBF_LONG, 1);
+    testTIMEeq("TST:capcnt", 13, 10*2); // time of trigger
+    {
+        const epicsUInt32 code[] = {25, 25, 50, 7};
+        const epicsUInt32 sec[] = {631152012, 631152012, 631152013, 631152013};
+        const epicsUInt32 ns[] = {4*2, 8*2, 10*2, 11*2};
+        testdbGetArrFieldEqual("TST:capE", DBF_ULONG, 8, NELEMENTS(code), code);
+        testdbGetArrFieldEqual("TST:capS", DBF_ULONG, 8, NELEMENTS(sec), sec);
+        testdbGetArrFieldEqual("TST:capN", DBF_ULONG, 8, NELEMENTS(ns), ns);
+    }
+
+    testDiag("Capture again, previous kept");
+    {
+        const epicsUInt32 evtlog[] = {50,631152014,1, 9,631152014,2};
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    testdbGetFieldEqual("TST:capcnt", DBF_LONG, 2);
+    {
+        const epicsUInt32 code[] = {7, 8, 50, 9};
+        const epicsUInt32 prev[] = {25, 25, 50, 7};
+        testdbGetArrFieldEqual("TST:capE", DBF_ULONG, 8, NELEMENTS(code), code);
+        testdbGetArrFieldEqual("TST:capH1", DBF_ULONG, 8, NELEMENTS(prev), prev);
+    }
+
+    testDiag("Discipline tick scaling");
+    testdbPutFieldOk("TST:mult2", DBF_DOUBLE, 8.0); /* nominal 125 MHz */
+    testdbPutFieldOk("TST:code3", DBF_LONG, 7);
+    testdbPutFieldOk("TST:disc2", DBF_LONG, 1);
+    {
+        /* +0.8 ppm, 125000100 ticks/sec.  code 5 every 31250025 ticks.
+         * last tick of second 10 is 125000000, so the largest tick alone
+         * would estimate 125000001.  code 6 is not periodic, and ignored.
+         */
+        const epicsUInt32 evtlog[] = {5,631152010,31249925, 6,631152010,31249930,
+                                      5,631152010,62499950, 5,631152010,93749975,
+                                      5,631152010,125000000, 6,631152011,3,
+                                      5,631152011,31249925};
+        testdbPutArrFieldOk("TST:input2", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    testVALnear("TST:freq2", 125.0001, 1e-9);
+    testVALnear("TST:corr2", 0.8, 1e-6);
+    {
+        /* half of 125000100 ticks */
+        const epicsUInt32 evtlog[] = {7,631152011,62500050};
+        testdbPutArrFieldOk("TST:input2", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    testTIMEeq("TST:last3", 11, 500000000);
+
+    testDiag("Discipline without periodic code");
+    testdbPutFieldOk("TST:mult3", DBF_DOUBLE, 8.0);
+    testdbPutFieldOk("TST:disc3", DBF_LONG, 1);
+    {
+        /* sparse.  largest tick of second 10 is 80 ppm short of nominal */
+        const epicsUInt32 evtlog[] = {5,631152010,100, 5,631152010,124990000, 5,631152011,5};
+        testdbPutArrFieldOk("TST:input3", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    testdbGetFieldEqual("TST:freq3", DBF_DOUBLE, 0.0); // rejected, not scanned
+    {
+        /* dense.  last tick of second 11 is within gap= of nominal */
+        const epicsUInt32 evtlog[] = {5,631152011,125000002, 5,631152012,3};
+        testdbPutArrFieldOk("TST:input3", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    testVALnear("TST:freq3", 125.000003, 1e-9);
+    {
+        /* second 12 estimates 125000001.  median of two, not the largest */
+        const epicsUInt32 evtlog[] = {5,631152012,125000000, 5,631152013,2};
+        testdbPutArrFieldOk("TST:input3", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    testVALnear("TST:freq3", 125.000002, 1e-9);
+
+    testDiag("Report");
+    testdbPutFieldOk("TST:events.PROC", DBF_LONG, 0);
+    testdbGetFieldEqual("TST:events", DBF_LONG, 12); // non-zero codes into LOG
+    testdbPutFieldOk("TST:occur1.PROC", DBF_LONG, 0);
+    testdbGetFieldEqual("TST:occur1", DBF_LONG, 2);
+    testdbPutFieldOk("TST:maxfill1.PROC", DBF_LONG, 0);
+    testdbGetFieldEqual("TST:maxfill1", DBF_LONG, 2);
+    testOk1(!iocshCmd("dbior drvEventTable 2"));
+    testOk1(!iocshCmd("dbior drvEventTable 2"));
 
     testIocShutdownOk();
     testdbCleanup();
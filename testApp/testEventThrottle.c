@@ -0,0 +1,61 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <string.h>
+
+#include <testMain.h>
+#include <alarm.h>
+#include <iocsh.h>
+#include <epicsEvent.h>
+#include <epicsThread.h>
+#include <callback.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+
+extern
+int testBitTable_registerRecordDeviceDriver(struct dbBase *);
+
+MAIN(testEventThrottle)
+{
+    testPlan(6);
+
+    testdbPrepare();
+    testdbReadDatabase("testBitTable.dbd", NULL, NULL);
+    testBitTable_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("testEventThrottle.db", NULL, "P=TST:");
+    testIocInitOk();
+
+    testDiag("First wakeup scans immediately");
+    {
+        const epicsUInt32 evtlog[] = {7,631152010,100};
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    testdbGetFieldEqual("TST:last", DBF_LONG, 1);
+
+    testDiag("Later wakeups within 1 second coalesced");
+    {
+        const epicsUInt32 evtlog[] = {7,631152010,200, 7,631152010,300, 7,631152010,400};
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    testdbGetFieldEqual("TST:last", DBF_LONG, 1);
+
+    testDiag("Trailing edge flushed");
+    epicsThreadSleep(1.5);
+    testSyncCallback();
+    testdbGetFieldEqual("TST:last", DBF_LONG, 4);
+    testdbGetFieldEqual("TST:suppressed", DBF_LONG, 3);
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
@@ -0,0 +1,88 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <string.h>
+
+#include <testMain.h>
+#include <alarm.h>
+#include <iocsh.h>
+#include <epicsTime.h>
+#include <epicsMonotonic.h>
+#include <dbAccess.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+
+extern
+int testBitTable_registerRecordDeviceDriver(struct dbBase *);
+
+static
+void testBenchmark(void)
+{
+    const unsigned N = 1000000u;
+    unsigned i, nerr = 0u;
+    epicsUInt64 start, end;
+
+    start = epicsMonotonicGet();
+    for(i=0u; i<N; i++) {
+        epicsTimeStamp ts;
+        if(epicsTimeGetEvent(&ts, 100))
+            nerr++;
+    }
+    end = epicsMonotonicGet();
+
+    testOk(nerr==0u, "%u lookup errors", nerr);
+    testDiag("epicsTimeGetEvent(, 100) %.1f ns/call",
+             (end-start)/(double)N);
+}
+
+MAIN(testEventTime)
+{
+    testPlan(7);
+
+    testdbPrepare();
+    testdbReadDatabase("testBitTable.dbd", NULL, NULL);
+    testBitTable_registerRecordDeviceDriver(pdbbase);
+
+    testOk1(iocshCmd("eventTimeProvider TST:LOG 50")==0);
+
+    testdbReadDatabase("testEventTime.db", NULL, "P=TST:");
+    testIocInitOk();
+
+    {
+        epicsTimeStamp ts;
+        testOk(epicsTimeGetEvent(&ts, 100)!=epicsTimeOK, "No time before first event");
+    }
+
+    testDiag("Push events");
+    {
+        const epicsUInt32 evtlog[] = {100,631152012,1, 101,631152012,2, 100,631152013,3};
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    {
+        epicsTimeStamp ts;
+        testOk(epicsTimeGetEvent(&ts, 101)==epicsTimeOK && ts.secPastEpoch==12 && ts.nsec==2,
+               "code 101 (%u, %u) == 12, 2", ts.secPastEpoch, ts.nsec);
+    }
+
+    testdbPutFieldOk("TST:stamp.PROC", DBF_LONG, 0);
+    {
+        dbCommon *prec = testdbRecordPtr("TST:stamp");
+        epicsTimeStamp ts;
+        dbScanLock(prec);
+        ts = prec->time;
+        dbScanUnlock(prec);
+        testOk(ts.secPastEpoch==13 && ts.nsec==3,
+               "TST:stamp.TIME (%u, %u) == 13, 3", ts.secPastEpoch, ts.nsec);
+    }
+
+    testBenchmark();
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
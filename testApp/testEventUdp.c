@@ -0,0 +1,157 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <string.h>
+
+#include <osiSock.h>
+
+#include <testMain.h>
+#include <alarm.h>
+#include <iocsh.h>
+#include <epicsThread.h>
+#include <dbAccess.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+
+#include "eventUdp.h"
+
+extern
+int testBitTable_registerRecordDeviceDriver(struct dbBase *);
+
+/* loopback receiver */
+static SOCKET rx = INVALID_SOCKET;
+static char buf[EVENTUDP_MAX_SIZE+16];
+
+static
+unsigned rxOpen(void)
+{
+    osiSockAddr addr;
+    osiSocklen_t alen = sizeof(addr);
+    struct timeval tmo = {5, 0};
+
+    rx = epicsSocketCreate(AF_INET, SOCK_DGRAM, 0);
+    if(rx==INVALID_SOCKET)
+        testAbort("Unable to create socket");
+
+    memset(&addr, 0, sizeof(addr));
+    addr.ia.sin_family = AF_INET;
+    addr.ia.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.ia.sin_port = 0;
+    if(bind(rx, &addr.sa, sizeof(addr.ia))
+            || getsockname(rx, &addr.sa, &alen))
+        testAbort("Unable to bind");
+
+    (void)setsockopt(rx, SOL_SOCKET, SO_RCVTIMEO, (char*)&tmo, sizeof(tmo));
+
+    return ntohs(addr.ia.sin_port);
+}
+
+/* receive one datagram.  returns number of records, or -1 */
+static
+int rxDatagram(eventUdpHeader *hdr, const eventUdpRecord **recs)
+{
+    int ret = recv(rx, buf, sizeof(buf), 0);
+    if(ret < (int)sizeof(*hdr)) {
+        testDiag("recv() -> %d", ret);
+        return -1;
+    }
+    memcpy(hdr, buf, sizeof(*hdr));
+    hdr->magic = ntohl(hdr->magic);
+    hdr->version = ntohs(hdr->version);
+    hdr->count = ntohs(hdr->count);
+    hdr->seqLo = ntohl(hdr->seqLo);
+    hdr->firstLo = ntohl(hdr->firstLo);
+    hdr->dropped = ntohl(hdr->dropped);
+    if(hdr->magic!=EVENTUDP_MAGIC || hdr->version!=EVENTUDP_VERSION
+            || ret != (int)(sizeof(*hdr) + hdr->count*sizeof(eventUdpRecord))) {
+        testDiag("Invalid datagram magic=%08x version=%u len=%d",
+                 (unsigned)hdr->magic, hdr->version, ret);
+        return -1;
+    }
+    *recs = (const eventUdpRecord*)&buf[sizeof(*hdr)];
+    return hdr->count;
+}
+
+static
+void testStat(const char *pv, double expect)
+{
+    DBADDR addr;
+    double val = -1.0;
+    long nReq = 1;
+
+    if(dbNameToAddr(pv, &addr))
+        testAbort("No %s", pv);
+
+    dbScanLock(addr.precord);
+    (void)dbProcess(addr.precord);
+    (void)dbGetField(&addr, DBR_DOUBLE, &val, NULL, &nReq, NULL);
+    dbScanUnlock(addr.precord);
+    testOk(val==expect, "%s (%g) == %g", pv, val, expect);
+}
+
+MAIN(testEventUdp)
+{
+    eventUdpHeader hdr;
+    const eventUdpRecord *recs = NULL;
+    char cmd[128];
+    unsigned port;
+    int n;
+
+    testPlan(11);
+
+    osiSockAttach();
+    port = rxOpen();
+    testDiag("Receive on 127.0.0.1:%u", port);
+
+    testdbPrepare();
+    testdbReadDatabase("testBitTable.dbd", NULL, NULL);
+    testBitTable_registerRecordDeviceDriver(pdbbase);
+
+    epicsSnprintf(cmd, sizeof(cmd), "eventUdpPublish TST:UDP TST:LOG 127.0.0.1:%u 0 \"\" 16", port);
+    testOk1(iocshCmd(cmd)==0);
+
+    testdbReadDatabase("testEventUdp.db", NULL, "P=TST:");
+    testIocInitOk();
+
+    testDiag("Push");
+    {
+        const epicsUInt32 evtlog[] = {100,631152012,1, 101,631152012,2, 102,631152013,0};
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+
+    n = rxDatagram(&hdr, &recs);
+    testOk(n==3, "count %d", n);
+    testOk(hdr.seqLo==0u && hdr.firstLo==1u, "seq %u first %u",
+           (unsigned)hdr.seqLo, (unsigned)hdr.firstLo);
+    testOk(n==3 && recs[0].code==100 && recs[1].code==101 && recs[2].code==102,
+           "codes %u %u %u", n>0 ? recs[0].code : 0u, n>1 ? recs[1].code : 0u, n>2 ? recs[2].code : 0u);
+    testOk(n==3 && ntohl(recs[2].sec)==ntohl(recs[0].sec)+1u, "sec %u %u",
+           n>2 ? (unsigned)ntohl(recs[0].sec) : 0u, n>2 ? (unsigned)ntohl(recs[2].sec) : 0u);
+
+    testDiag("Push again");
+    {
+        const epicsUInt32 evtlog[] = {103,631152014,0};
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+
+    n = rxDatagram(&hdr, &recs);
+    testOk(n==1 && hdr.seqLo==1u && hdr.firstLo==4u && recs[0].code==103,
+           "count %d seq %u first %u", n, (unsigned)hdr.seqLo, (unsigned)hdr.firstLo);
+
+    /* counters updated after send() */
+    epicsThreadSleep(0.1);
+    testStat("TST:events", 4.0);
+    testStat("TST:datagrams", 2.0);
+    testStat("TST:dropped", 0.0);
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    epicsSocketDestroy(rx);
+
+    return testDone();
+}
@@ -0,0 +1,58 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <testMain.h>
+#include <alarm.h>
+#include <dbAccess.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+
+extern
+int testBitTable_registerRecordDeviceDriver(struct dbBase *);
+
+MAIN(testEvrOutputs)
+{
+    testPlan(13);
+
+    testdbPrepare();
+    testdbReadDatabase("testBitTable.dbd", NULL, NULL);
+    testBitTable_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("testEvrOutputs.db", NULL, "P=TST:");
+    testIocInitOk();
+
+    testdbGetFieldEqual("TST:1:delay_", DBF_LONG, 0);
+
+    testDiag("Apply 10 ns per tick");
+    testdbPutFieldOk("TST:scale", DBF_DOUBLE, 10.0);
+    /* I/O Intr scan, then completion of TST:scale */
+    testSyncCallback();
+    testSyncCallback();
+
+    testdbGetFieldEqual("TST:1:delay_", DBF_LONG, 10);
+    testdbGetFieldEqual("TST:1:width_", DBF_LONG, 5);
+    testdbGetFieldEqual("TST:2:delay_", DBF_LONG, 100);
+    testdbGetFieldEqual("TST:done", DBF_LONG, 1);
+
+    testDiag("Change delay");
+    testdbPutFieldOk("TST:1:delay", DBF_DOUBLE, 123.0);
+    testdbGetFieldEqual("TST:1:delay_", DBF_LONG, 12);
+
+    testDiag("Re-scale, 8 ns per tick");
+    testdbPutFieldOk("TST:scale", DBF_DOUBLE, 8.0);
+    testSyncCallback();
+    testSyncCallback();
+
+    testdbGetFieldEqual("TST:1:delay_", DBF_LONG, 15);
+    testdbGetFieldEqual("TST:1:width_", DBF_LONG, 6);
+    testdbGetFieldEqual("TST:2:delay_", DBF_LONG, 125);
+    testdbGetFieldEqual("TST:done", DBF_LONG, 2);
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
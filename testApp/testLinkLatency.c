@@ -0,0 +1,139 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <string.h>
+
+#include <testMain.h>
+#include <alarm.h>
+#include <iocsh.h>
+#include <epicsEvent.h>
+#include <callback.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+
+extern
+int testBitTable_registerRecordDeviceDriver(struct dbBase *);
+
+MAIN(testLinkLatency)
+{
+    testPlan(26);
+
+    testdbPrepare();
+    testdbReadDatabase("testBitTable.dbd", NULL, NULL);
+    testBitTable_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("testLinkLatency.db", NULL, "P=TST:");
+    testIocInitOk();
+
+    testDiag("Probe seen by node 0 before, and node 1 after, the reference");
+    testdbPutFieldOk("TST:fire", DBF_LONG, 0);
+    testdbGetFieldEqual("TST:fire", DBF_LONG, 100);
+    {
+        const epicsUInt32 evtlog[] = {100, 631152010, 150};
+        testdbPutArrFieldOk("TST:n0", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    {
+        const epicsUInt32 evtlog[] = {100, 631152010, 100};
+        testdbPutArrFieldOk("TST:ref", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    {
+        const epicsUInt32 evtlog[] = {100, 631152010, 300};
+        testdbPutArrFieldOk("TST:n1", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    {
+        const double mean[] = {50.0, 200.0};
+        testdbGetArrFieldEqual("TST:mean", DBF_DOUBLE, 2, NELEMENTS(mean), mean);
+    }
+    {
+        const double count[] = {1.0, 1.0};
+        testdbGetArrFieldEqual("TST:count", DBF_DOUBLE, 2, NELEMENTS(count), count);
+    }
+    {
+        const epicsUInt32 hist[] = {1, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+        testdbGetArrFieldEqual("TST:hist0", DBF_ULONG, 10, NELEMENTS(hist), hist);
+    }
+    {
+        const epicsUInt32 hist[] = {0, 0, 1, 0, 0, 0, 0, 0, 0, 0};
+        testdbGetArrFieldEqual("TST:hist1", DBF_ULONG, 10, NELEMENTS(hist), hist);
+    }
+
+    testDiag("Probe lost to both nodes");
+    testdbPutFieldOk("TST:fire", DBF_LONG, 0);
+    {
+        const epicsUInt32 evtlog[] = {100, 631152011, 100};
+        testdbPutArrFieldOk("TST:ref", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testdbPutFieldOk("TST:fire", DBF_LONG, 0);
+    testSyncCallback();
+    {
+        const double missed[] = {1.0, 1.0};
+        testdbGetArrFieldEqual("TST:missed", DBF_DOUBLE, 2, NELEMENTS(missed), missed);
+    }
+    {
+        const double count[] = {1.0, 1.0};
+        testdbGetArrFieldEqual("TST:count", DBF_DOUBLE, 2, NELEMENTS(count), count);
+    }
+
+    testDiag("Sequencer fired.  node 0 sees the next probe before the reference");
+    {
+        const epicsUInt32 evtlog[] = {100, 631152012, 100};
+        testdbPutArrFieldOk("TST:ref", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    {
+        const epicsUInt32 evtlog[] = {100, 631152012, 150};
+        testdbPutArrFieldOk("TST:n0", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    {
+        const epicsUInt32 evtlog[] = {100, 631152012, 300};
+        testdbPutArrFieldOk("TST:n1", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    {
+        const epicsUInt32 evtlog[] = {100, 631152013, 150};
+        testdbPutArrFieldOk("TST:n0", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    {
+        const epicsUInt32 evtlog[] = {100, 631152013, 100};
+        testdbPutArrFieldOk("TST:ref", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    {
+        const epicsUInt32 evtlog[] = {100, 631152013, 300};
+        testdbPutArrFieldOk("TST:n1", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    {
+        const epicsUInt32 evtlog[] = {100, 631152014, 100};
+        testdbPutArrFieldOk("TST:ref", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    {
+        const epicsUInt32 evtlog[] = {100, 631152014, 150};
+        testdbPutArrFieldOk("TST:n0", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    {
+        const epicsUInt32 evtlog[] = {100, 631152014, 300};
+        testdbPutArrFieldOk("TST:n1", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    {
+        const double missed[] = {1.0, 1.0};
+        testdbGetArrFieldEqual("TST:missed", DBF_DOUBLE, 2, NELEMENTS(missed), missed);
+    }
+    {
+        const double count[] = {4.0, 4.0};
+        testdbGetArrFieldEqual("TST:count", DBF_DOUBLE, 2, NELEMENTS(count), count);
+    }
+    {
+        const double mean[] = {50.0, 200.0};
+        testdbGetArrFieldEqual("TST:mean", DBF_DOUBLE, 2, NELEMENTS(mean), mean);
+    }
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
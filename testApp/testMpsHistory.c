@@ -0,0 +1,77 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <string.h>
+
+#include <testMain.h>
+#include <alarm.h>
+#include <callback.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+
+extern
+int testBitTable_registerRecordDeviceDriver(struct dbBase *);
+
+static
+void testTrip(epicsUInt32 inputs, epicsUInt32 sec, epicsUInt32 ticks)
+{
+    testdbPutFieldOk("TST:in", DBF_ULONG, inputs);
+    testdbPutFieldOk("TST:sec", DBF_ULONG, sec);
+    testdbPutFieldOk("TST:tck", DBF_ULONG, ticks);
+    testSyncCallback();
+}
+
+MAIN(testMpsHistory)
+{
+    testPlan(18);
+
+    testdbPrepare();
+    testdbReadDatabase("testBitTable.dbd", NULL, NULL);
+    testBitTable_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("testMpsHistory.db", NULL, "P=TST:");
+    testIocInitOk();
+
+    testDiag("Trigger on MPS code");
+    {
+        const epicsUInt32 evtlog[] = {5,631152012,1, 127,631152012,2};
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    testdbGetFieldEqual("TST:trig", DBF_LONG, 127);
+
+    testDiag("First trip");
+    testTrip(3, 631152020, 100);
+    testdbGetFieldEqual("TST:cnt", DBF_LONG, 1);
+    {
+        const epicsUInt32 inp[] = {3};
+        const epicsUInt32 sec[] = {631152020};
+        const epicsUInt32 ns[] = {100};
+        testdbGetArrFieldEqual("TST:I", DBF_ULONG, 4, NELEMENTS(inp), inp);
+        testdbGetArrFieldEqual("TST:S", DBF_ULONG, 4, NELEMENTS(sec), sec);
+        testdbGetArrFieldEqual("TST:N", DBF_ULONG, 4, NELEMENTS(ns), ns);
+    }
+
+    testDiag("Re-read of same trip ignored");
+    testTrip(3, 631152020, 100);
+    testdbGetFieldEqual("TST:cnt", DBF_LONG, 1);
+
+    testDiag("Second trip, newest first");
+    testTrip(5, 631152021, 7);
+    testdbGetFieldEqual("TST:cnt", DBF_LONG, 2);
+    {
+        const epicsUInt32 inp[] = {5, 3};
+        testdbGetArrFieldEqual("TST:I", DBF_ULONG, 4, NELEMENTS(inp), inp);
+    }
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
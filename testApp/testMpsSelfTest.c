@@ -0,0 +1,73 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <string.h>
+
+#include <testMain.h>
+#include <alarm.h>
+#include <iocsh.h>
+#include <epicsThread.h>
+#include <envDefs.h>
+#include <dbAccess.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+#include <longinRecord.h>
+
+extern
+int testBitTable_registerRecordDeviceDriver(struct dbBase *);
+
+MAIN(testMpsSelfTest)
+{
+    unsigned i;
+    epicsInt32 state = 0;
+
+    testPlan(9);
+
+    /* nothing to find */
+    epicsEnvSet("EPICS_CA_AUTO_ADDR_LIST", "NO");
+    epicsEnvSet("EPICS_CA_ADDR_LIST", "127.0.0.1");
+
+    testdbPrepare();
+    testdbReadDatabase("testBitTable.dbd", NULL, NULL);
+    testBitTable_registerRecordDeviceDriver(pdbbase);
+
+    /* 1 input -> 2 + 1*(4+2) steps */
+    testOk1(iocshCmd("mpsSelfTestConfigure TST TST:EVG: \"TST:NOEVR:1: TST:NOEVR:2:\" 1 1 0.01")==0);
+
+    testdbReadDatabase("testMpsSelfTest.db", NULL, "P=TST:");
+    testIocInitOk();
+
+    testdbGetFieldEqual("TST:nsteps", DBF_LONG, 8);
+    testdbGetFieldEqual("TST:state", DBF_LONG, 0);
+
+    testDiag("Run against unreachable nodes");
+    testdbPutFieldOk("TST:start", DBF_LONG, 1);
+
+    /* connect timeout, then aborts at first clear with no EVG */
+    for(i=0u; i<200u && state<2; i++) {
+        longinRecord *prec = (longinRecord*)testdbRecordPtr("TST:state");
+        epicsThreadSleep(0.1);
+        dbScanLock((dbCommon*)prec);
+        state = prec->val;
+        dbScanUnlock((dbCommon*)prec);
+    }
+    testOk(state==3, "state %d", (int)state);
+    testdbGetFieldEqual("TST:step", DBF_LONG, 1);
+    testdbGetFieldEqual("TST:nfail", DBF_LONG, 2);
+    {
+        const epicsUInt32 result[] = {3, 0, 0, 0, 0, 0, 0, 0,
+                                      3, 0, 0, 0, 0, 0, 0, 0};
+        const epicsUInt32 nodeFail[] = {1, 1};
+        testdbGetArrFieldEqual("TST:result", DBF_ULONG, 32, NELEMENTS(result), result);
+        testdbGetArrFieldEqual("TST:nodeFail", DBF_ULONG, 4, NELEMENTS(nodeFail), nodeFail);
+    }
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
@@ -0,0 +1,82 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <testMain.h>
+#include <alarm.h>
+#include <epicsThread.h>
+#include <dbAccess.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+
+extern
+int testBitTable_registerRecordDeviceDriver(struct dbBase *);
+
+static
+double testRead(const char *pv)
+{
+    DBADDR addr;
+    double val = -1.0;
+    long nReq = 1;
+
+    if(dbNameToAddr(pv, &addr))
+        testAbort("No %s", pv);
+
+    dbScanLock(addr.precord);
+    (void)dbProcess(addr.precord);
+    (void)dbGetField(&addr, DBR_DOUBLE, &val, NULL, &nReq, NULL);
+    dbScanUnlock(addr.precord);
+    return val;
+}
+
+MAIN(testPhaseTiming)
+{
+    double t1, t2, total;
+
+    testPlan(17);
+
+    testdbPrepare();
+    testdbReadDatabase("testBitTable.dbd", NULL, NULL);
+    testBitTable_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("testPhaseTiming.db", NULL, "P=TST:");
+    testIocInitOk();
+
+    testDiag("Marks before start are ignored");
+    testdbPutFieldOk("TST:ph1", DBF_LONG, 1);
+    testdbPutFieldOk("TST:ph2", DBF_LONG, 1);
+    testOk1(testRead("TST:count")==0.0);
+
+    testDiag("Complete cycle");
+    testdbPutFieldOk("TST:start", DBF_LONG, 1);
+    epicsThreadSleep(0.1);
+    testdbPutFieldOk("TST:ph1", DBF_LONG, 1);
+    epicsThreadSleep(0.2);
+    testdbPutFieldOk("TST:ph2", DBF_LONG, 1);
+
+    t1 = testRead("TST:t1");
+    t2 = testRead("TST:t2");
+    total = testRead("TST:total");
+    testOk(t1>=0.09 && t1<t2, "phase 1 %f s", t1);
+    testOk(t2>=0.19, "phase 2 %f s", t2);
+    testOk(total>=t1+t2-1e-6, "total %f s", total);
+    testOk1(testRead("TST:count")==1.0);
+
+    testDiag("Shorter cycle keeps max");
+    testdbPutFieldOk("TST:start", DBF_LONG, 1);
+    testdbPutFieldOk("TST:ph1", DBF_LONG, 1);
+    testdbPutFieldOk("TST:ph2", DBF_LONG, 1);
+
+    testOk(testRead("TST:total")<total, "total %f s", testRead("TST:total"));
+    testOk1(testRead("TST:totalMax")==total);
+
+    testdbPutFieldOk("TST:reset", DBF_LONG, 1);
+    testOk1(testRead("TST:totalMax")==0.0);
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
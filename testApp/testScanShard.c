@@ -0,0 +1,98 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <string.h>
+
+#include <testMain.h>
+#include <alarm.h>
+#include <iocsh.h>
+#include <epicsThread.h>
+#include <dbAccess.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+
+extern
+int testBitTable_registerRecordDeviceDriver(struct dbBase *);
+
+/* I/O Intr scans are processed by worker threads, not callback queues */
+static
+void testPollLong(const char *pv, epicsInt32 expect)
+{
+    DBADDR addr;
+    epicsInt32 val = -1;
+    unsigned i;
+
+    if(dbNameToAddr(pv, &addr))
+        testAbort("No %s", pv);
+
+    for(i=0u; i<50u; i++) {
+        long nReq = 1;
+        dbScanLock(addr.precord);
+        (void)dbGetField(&addr, DBR_LONG, &val, NULL, &nReq, NULL);
+        dbScanUnlock(addr.precord);
+        if(val==expect)
+            break;
+        epicsThreadSleep(0.1);
+    }
+    testOk(val==expect, "%s (%d) == %d", pv, (int)val, (int)expect);
+}
+
+static
+void testAtLeast(const char *pv, double min)
+{
+    DBADDR addr;
+    double val = -1.0;
+    long nReq = 1;
+
+    if(dbNameToAddr(pv, &addr))
+        testAbort("No %s", pv);
+
+    dbScanLock(addr.precord);
+    (void)dbProcess(addr.precord);
+    (void)dbGetField(&addr, DBR_DOUBLE, &val, NULL, &nReq, NULL);
+    dbScanUnlock(addr.precord);
+    testOk(val>=min, "%s (%g) >= %g", pv, val, min);
+}
+
+MAIN(testScanShard)
+{
+    testPlan(10);
+
+    testdbPrepare();
+    testdbReadDatabase("testBitTable.dbd", NULL, NULL);
+    testBitTable_registerRecordDeviceDriver(pdbbase);
+
+    testOk1(iocshCmd("scanShardConfigure 2 50")==0);
+    testOk1(iocshCmd("scanShardAssign TST:LOGA 0")==0);
+    testOk1(iocshCmd("scanShardAssign TST:LOGB 1")==0);
+
+    testdbReadDatabase("testScanShard.db", NULL, "P=TST:");
+    testIocInitOk();
+
+    testDiag("Push A");
+    {
+        const epicsUInt32 evtlog[] = {100,631152012,1};
+        testdbPutArrFieldOk("TST:inputA", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testPollLong("TST:lastA", 1);
+    testdbGetFieldEqual("TST:lastB", DBF_LONG, 0);
+
+    testDiag("Push B");
+    {
+        const epicsUInt32 evtlog[] = {100,631152012,2, 100,631152012,3};
+        testdbPutArrFieldOk("TST:inputB", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testPollLong("TST:lastB", 2);
+
+    testAtLeast("TST:count0", 1.0);
+    testAtLeast("TST:count1", 1.0);
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
@@ -0,0 +1,102 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <string.h>
+
+#include <testMain.h>
+#include <alarm.h>
+#include <iocsh.h>
+#include <epicsEvent.h>
+#include <callback.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+
+extern
+int testBitTable_registerRecordDeviceDriver(struct dbBase *);
+
+MAIN(testSeqVerify)
+{
+    testPlan(20);
+
+    testdbPrepare();
+    testdbReadDatabase("testBitTable.dbd", NULL, NULL);
+    testBitTable_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("testSeqVerify.db", NULL, "P=TST:");
+    testIocInitOk();
+
+    testDiag("Store pattern");
+    {
+        const epicsUInt8 codes[] = {5, 10, 15};
+        const epicsUInt32 delays[] = {500, 100, 200}; // relative to previous entry
+        testdbPutArrFieldOk("TST:mux.A", DBF_UCHAR, NELEMENTS(codes), codes);
+        testdbPutArrFieldOk("TST:mux.B", DBF_ULONG, NELEMENTS(delays), delays);
+        testdbPutFieldOk("TST:mux.PROC", DBF_LONG, 0);
+    }
+    testSyncCallback();
+    testdbGetFieldEqual("TST:entries", DBF_LONG, 3);
+    {
+        const double expect[] = {0.0, 100.0, 300.0};
+        testdbGetArrFieldEqual("TST:expected", DBF_DOUBLE, 16, NELEMENTS(expect), expect);
+    }
+
+    testDiag("Disabled by default");
+    {
+        const epicsUInt32 evtlog[] = {5,631152009,1000, 10,631152009,1100, 15,631152009,1300};
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    testdbGetFieldEqual("TST:matched", DBF_LONG, 0);
+    testdbPutFieldOk("TST:ena", DBF_LONG, 1);
+
+    testDiag("Complete pass, pass missing an entry, out of order code");
+    {
+        const epicsUInt32 evtlog[] = {
+            5,631152010,1000, 10,631152010,1105, 15,631152010,1290, // errors 0, 5, -10
+            5,631152010,5000, 15,631152010,5300,                    // 10 missed
+            10,631152010,8000,                                      // unexpected
+        };
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    testdbGetFieldEqual("TST:passes", DBF_LONG, 2);
+    testdbGetFieldEqual("TST:matched", DBF_LONG, 5);
+    testdbGetFieldEqual("TST:missed", DBF_LONG, 1);
+    testdbGetFieldEqual("TST:unexpected", DBF_LONG, 1);
+    testdbGetFieldEqual("TST:outOfTol", DBF_LONG, 0);
+    {
+        const double expect[] = {2.0, 1.0, 2.0};
+        testdbGetArrFieldEqual("TST:count", DBF_DOUBLE, 16, NELEMENTS(expect), expect);
+    }
+    {
+        const double expect[] = {0.0, 5.0, -5.0};
+        testdbGetArrFieldEqual("TST:errMean", DBF_DOUBLE, 16, NELEMENTS(expect), expect);
+    }
+
+    testDiag("Late entry, then last entry overdue");
+    {
+        const epicsUInt32 evtlog[] = {
+            5,631152010,9000, 10,631152010,9200, // error 100
+            20,631152010,20000,                  // not in pattern
+        };
+        testdbPutArrFieldOk("TST:input", DBF_ULONG, NELEMENTS(evtlog), evtlog);
+    }
+    testSyncCallback();
+    testdbGetFieldEqual("TST:passes", DBF_LONG, 3);
+    testdbGetFieldEqual("TST:outOfTol", DBF_LONG, 1);
+    {
+        const double expect[] = {0.0, 1.0, 1.0};
+        testdbGetArrFieldEqual("TST:miss", DBF_DOUBLE, 16, NELEMENTS(expect), expect);
+    }
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
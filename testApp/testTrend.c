@@ -0,0 +1,105 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+
+#define USE_TYPED_RSET
+
+#include <string.h>
+#include <math.h>
+
+#include <testMain.h>
+#include <alarm.h>
+#include <epicsTime.h>
+#include <epicsThread.h>
+#include <dbAccess.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+#include <callback.h>
+
+extern
+int testBitTable_registerRecordDeviceDriver(struct dbBase *);
+
+/* wait until just after the start of a 0.5 second bucket */
+static
+void syncBucket(void)
+{
+    while(1) {
+        epicsTimeStamp now;
+        double frac;
+        epicsTimeGetCurrent(&now);
+        frac = fmod(now.secPastEpoch + now.nsec*1e-9, 0.5);
+        if(frac < 0.05)
+            break;
+        epicsThreadSleep(0.5 - frac);
+    }
+}
+
+MAIN(testTrend)
+{
+    testPlan(21);
+
+    testdbPrepare();
+    testdbReadDatabase("testBitTable.dbd", NULL, NULL);
+    testBitTable_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("testTrend.db", NULL, "P=TST:");
+    testIocInitOk();
+
+    testDiag("Fill first bucket");
+    syncBucket();
+    testdbPutFieldOk("TST:sample", DBF_DOUBLE, 1.0);
+    testdbPutFieldOk("TST:sample", DBF_DOUBLE, 3.0);
+
+    testdbPutFieldOk("TST:mean.PROC", DBF_LONG, 0);
+    testdbGetFieldEqual("TST:mean.NORD", DBF_LONG, 0);
+
+    testDiag("Next bucket completes the first");
+    epicsThreadSleep(0.5);
+    testdbPutFieldOk("TST:sample", DBF_DOUBLE, 5.0);
+
+    testdbPutFieldOk("TST:min.PROC", DBF_LONG, 0);
+    testdbPutFieldOk("TST:max.PROC", DBF_LONG, 0);
+    testdbPutFieldOk("TST:mean.PROC", DBF_LONG, 0);
+    {
+        const double min[] = {1.0}, max[] = {3.0}, mean[] = {2.0};
+        testdbGetArrFieldEqual("TST:min", DBF_DOUBLE, 4, NELEMENTS(min), min);
+        testdbGetArrFieldEqual("TST:max", DBF_DOUBLE, 4, NELEMENTS(max), max);
+        testdbGetArrFieldEqual("TST:mean", DBF_DOUBLE, 4, NELEMENTS(mean), mean);
+    }
+
+    testDiag("Wider tier not yet complete");
+    testdbPutFieldOk("TST:mean1.PROC", DBF_LONG, 0);
+    testdbGetFieldEqual("TST:mean1.NORD", DBF_LONG, 0);
+
+    testDiag("Triggered snapshot of raw ring");
+    testdbPutFieldOk("TST:sample", DBF_DOUBLE, 10.0);
+    testdbPutFieldOk("TST:trig", DBF_LONG, 1);
+    testdbPutFieldOk("TST:sample", DBF_DOUBLE, 20.0);
+    testdbPutFieldOk("TST:sample", DBF_DOUBLE, 30.0);
+    testdbGetFieldEqual("TST:snapV.NORD", DBF_LONG, 0);
+    testdbPutFieldOk("TST:sample", DBF_DOUBLE, 40.0);
+    testSyncCallback();
+    {
+        const double val[] = {10.0, 20.0, 30.0, 40.0};
+        testdbGetArrFieldEqual("TST:snapV", DBF_DOUBLE, 4, NELEMENTS(val), val);
+    }
+    {
+        DBADDR addr;
+        double time[4] = {0.0, 0.0, 0.0, 0.0};
+        long nReq = NELEMENTS(time);
+        if(dbNameToAddr("TST:snapT", &addr)) {
+            testAbort("No TST:snapT");
+        }
+        dbScanLock(addr.precord);
+        (void)dbGetField(&addr, DBR_DOUBLE, time, NULL, &nReq, NULL);
+        dbScanUnlock(addr.precord);
+        testOk(nReq==4 && time[0]<=0.0 && time[1]>=0.0 && time[3]>=time[1],
+               "time relative to trigger %g %g %g %g", time[0], time[1], time[2], time[3]);
+    }
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
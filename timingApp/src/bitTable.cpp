@@ -43,7 +43,10 @@
 
 #include <epicsExport.h>
 
+#include "scanShard.h"
+
 namespace {
+using namespace ospreyTiming;
 
 typedef epicsGuard<epicsMutex> Guard;
 
@@ -56,7 +59,7 @@ std::map<std::string, std::unique_ptr<BitTable>> bitTables;
 struct BitTable {
     const std::string name;
     const unsigned nEvents = 256u;
-    IOSCANPVT onChange;
+    ShardScan onChange;
 
     epicsMutex lock;
 
@@ -72,7 +75,7 @@ struct BitTable {
     BitTable(const std::string& name)
         :name(name)
     {
-        scanIoInit(&onChange);
+        shardScanInit(onChange, scanShardFor(name), nullptr, nullptr);
     }
 
     static
@@ -229,7 +232,7 @@ long bitTableSetWords(longoutRecord *prec) noexcept
 
             pvt->table->changing = true;
         }
-        scanIoRequest(pvt->table->onChange);
+        shardScanRequest(pvt->table->onChange);
 
         return 0;
     } CATCH
@@ -289,7 +292,7 @@ long bitTableUpdate(longoutRecord *prec) noexcept
             pvt->table->changing = true;
         }
         if(change)
-            scanIoRequest(pvt->table->onChange);
+            shardScanRequest(pvt->table->onChange);
 
         return 0;
     } CATCH
@@ -308,7 +311,7 @@ long bitTableChanged(int detach, struct dbCommon *prec, IOSCANPVT* pscan) noexce
     if(!pvt)
         return -1;
 
-    *pscan = pvt->table->onChange;
+    *pscan = pvt->table->onChange.scan;
     return 0;
 }
 
@@ -0,0 +1,490 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* Host side model of device time
+ *
+ * Fit (device time) = offset + rate * (host monotonic time) by linear
+ * regression over a window of samples.  Samples are taken from periodic
+ * reads of the device time (eg. EVR:now).  Device time is given relative
+ * to a fixed epoch, so that a double keeps ns resolution.  The host time
+ * of a sample is the TIME of the read, through TSEL.
+ *
+ * Optionally also observe the PPS event code in an EventLog.  A PPS event
+ * can not have happened after it was received.  So if the model predicts
+ * a device time earlier than a received PPS, then the offset is advanced.
+ *
+ * Output:
+ *   - interpolated device time, with one sigma error estimate (ai)
+ *   - as generalTime current time provider
+ */
+
+#include <map>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <deque>
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define USE_TYPED_DRVET
+#define USE_TYPED_RSET
+#define USE_TYPED_DSET
+
+#include <epicsTypes.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsString.h>
+#include <epicsStdio.h>
+#include <epicsTime.h>
+#include <epicsMath.h>
+#include <epicsMonotonic.h>
+#include <generalTimeSup.h>
+#include <iocsh.h>
+#include <errlog.h>
+
+#include <alarm.h>
+#include <dbAccess.h>
+#include <devSup.h>
+#include <recGbl.h>
+#include <dbCommon.h>
+#include <aiRecord.h>
+#include <aoRecord.h>
+
+#include <epicsExport.h>
+
+#include "eventTable.h"
+#include "clockModel.h"
+
+namespace ospreyTiming {
+
+struct ClockModel : public EventLogObserver {
+    struct Sample {
+        uint64_t mono; // host monotonic ns
+        int64_t dev;   // device ns since POSIX epoch
+    };
+
+    epicsMutex lock;
+
+    size_t window = 16u;
+    std::deque<Sample> samples;
+
+    // fit, relative to samples.back()
+    bool valid = false;
+    Sample ref{};
+    double a = 0.0, b = 1.0; // (s), (s/s)
+    double xmean = 0.0, sxx = 0.0;
+    double s2 = 0.0; // residual variance (s^2)
+    size_t n = 0u;
+
+    // PPS causality correction
+    uint8_t ppsCode = 0u; // 0 when not attached
+    int64_t adjust = 0; // ns added to prediction since last fit
+    double ppsLag = 0.0; // (s) prediction - device time of last PPS at receipt
+
+    virtual ~ClockModel() {}
+
+    // must lock
+    void fit()
+    {
+        valid = false;
+        n = samples.size();
+        if(n<3u)
+            return;
+
+        ref = samples.back();
+
+        double ymean = 0.0;
+        xmean = 0.0;
+        for(auto& S : samples) {
+            xmean += int64_t(S.mono - ref.mono)*1e-9;
+            ymean += (S.dev - ref.dev)*1e-9;
+        }
+        xmean /= n;
+        ymean /= n;
+
+        double sxy = 0.0;
+        sxx = 0.0;
+        for(auto& S : samples) {
+            double dx = int64_t(S.mono - ref.mono)*1e-9 - xmean;
+            double dy = (S.dev - ref.dev)*1e-9 - ymean;
+            sxx += dx*dx;
+            sxy += dx*dy;
+        }
+        if(sxx<=0.0)
+            return; // all samples at the same host time?
+
+        b = sxy/sxx;
+        a = ymean - b*xmean;
+
+        double ssr = 0.0;
+        for(auto& S : samples) {
+            double x = int64_t(S.mono - ref.mono)*1e-9;
+            double r = (S.dev - ref.dev)*1e-9 - (a + b*x);
+            ssr += r*r;
+        }
+        s2 = ssr/(n-2u);
+        adjust = 0;
+        valid = true;
+    }
+
+    // must lock
+    void add(uint64_t mono, int64_t dev)
+    {
+        samples.push_back(Sample{mono, dev});
+        while(samples.size() > window)
+            samples.pop_front();
+        fit();
+    }
+
+    // must lock.  Requires valid
+    int64_t predict(uint64_t mono, double* err) const
+    {
+        double x = int64_t(mono - ref.mono)*1e-9;
+        if(err)
+            *err = sqrt(s2*(1.0/n + (x-xmean)*(x-xmean)/sxx));
+        return ref.dev + llround((a + b*x)*1e9) + adjust;
+    }
+
+    virtual void onEvents(const EventRec* recs, size_t nrecs) override final
+    {
+        auto recv = epicsMonotonicGet();
+        epicsGuard<epicsMutex> G(lock);
+
+        if(!valid)
+            return;
+
+        for(size_t i=0u; i<nrecs; i++) {
+            auto& rec = recs[i];
+            if(rec.code!=ppsCode)
+                continue;
+
+            int64_t pps = (int64_t(rec.ts.secPastEpoch) + POSIX_TIME_AT_EPICS_EPOCH)*1000000000
+                    + rec.ts.nsec;
+            auto lag = predict(recv, nullptr) - pps;
+            ppsLag = lag*1e-9;
+            if(lag<0)
+                adjust -= lag;
+        }
+    }
+};
+
+} // namespace ospreyTiming
+
+namespace {
+using namespace ospreyTiming;
+
+typedef epicsGuard<epicsMutex> Guard;
+
+epicsMutex modelsLock;
+std::map<std::string, std::unique_ptr<ClockModel>> models;
+
+ClockModel* clockModelGetCreate(const std::string& name)
+{
+    Guard G(modelsLock);
+    auto& ent = models[name];
+    if(!ent)
+        ent.reset(new ClockModel);
+    return ent.get();
+}
+
+void toTimeStamp(epicsTimeStamp* ts, int64_t dev)
+{
+    ts->secPastEpoch = epicsUInt32(dev/1000000000 - POSIX_TIME_AT_EPICS_EPOCH);
+    ts->nsec = epicsUInt32(dev%1000000000);
+}
+
+struct ModelDev {
+    dbCommon* const prec;
+    ClockModel* const model;
+
+    int64_t epoch = 0; // ns since POSIX epoch.  Added to sample VAL
+
+    enum stat_t {
+        Now, Err, Rate, Lag, N,
+    } stat = Now;
+
+    ModelDev(dbCommon *prec, ClockModel* model)
+        :prec(prec), model(model)
+    {}
+};
+
+long clockModelInitRecord(dbCommon *prec) noexcept {
+    try {
+        auto plink(dbGetDevLink(prec));
+        assert(plink->type==INST_IO);
+        std::string lstr(plink->value.instio.string);
+
+        std::string modelName, logName;
+        size_t window = 0u;
+        int64_t epoch = 0; // POSIX seconds
+        int pps = 0;
+        ModelDev::stat_t stat = ModelDev::Now;
+
+        char *saved = nullptr;
+        for(char* word = epicsStrtok_r((char*)lstr.data(), " ", &saved)
+             ; word
+             ; word = epicsStrtok_r(NULL, " ", &saved))
+        {
+            auto wlen = strlen(word);
+
+            auto cmd = [=](const char *pref) -> const char* {
+                auto plen = strlen(pref);
+                if(wlen >= plen && memcmp(word, pref, plen)==0) {
+                    return word + plen;
+                }
+                return nullptr;
+            };
+
+            if(auto val = cmd("model=")) {
+                modelName = val;
+
+            } else if(auto val = cmd("window=")) {
+                window = std::stoul(val, nullptr, 0);
+
+            } else if(auto val = cmd("log=")) {
+                logName = val;
+
+            } else if(auto val = cmd("epoch=")) {
+                epoch = std::stoll(val, nullptr, 0);
+
+            } else if(auto val = cmd("pps=")) {
+                pps = std::stoi(val, nullptr, 0);
+
+            } else if(auto val = cmd("stat=")) {
+                if(epicsStrCaseCmp(val, "now")==0) {
+                    stat = ModelDev::Now;
+                } else if(epicsStrCaseCmp(val, "err")==0) {
+                    stat = ModelDev::Err;
+                } else if(epicsStrCaseCmp(val, "rate")==0) {
+                    stat = ModelDev::Rate;
+                } else if(epicsStrCaseCmp(val, "lag")==0) {
+                    stat = ModelDev::Lag;
+                } else if(epicsStrCaseCmp(val, "n")==0) {
+                    stat = ModelDev::N;
+                } else {
+                    throw std::runtime_error("stat= must be 'now', 'err', 'rate', 'lag', or 'n'");
+                }
+
+            } else {
+                throw std::runtime_error("Unexpected dev. link parameter");
+            }
+        }
+
+        if(modelName.empty())
+            throw std::runtime_error("Missing model=");
+        if(logName.empty() != !pps)
+            throw std::runtime_error("log= and pps= must be given together");
+        if(pps<0 || pps>255)
+            throw std::runtime_error("pps= must be an event code 1-255");
+
+        auto model = clockModelGetCreate(modelName);
+
+        if(window) {
+            if(window<3u)
+                throw std::runtime_error("window= must be >=3");
+            Guard G(model->lock);
+            model->window = window;
+        }
+
+        if(pps) {
+            {
+                Guard G(model->lock);
+                if(model->ppsCode)
+                    throw std::runtime_error("PPS already attached");
+                model->ppsCode = pps;
+            }
+            eventLogAttach(logName, model);
+        }
+
+        auto pvt = new ModelDev(prec, model);
+        pvt->stat = stat;
+        pvt->epoch = epoch*1000000000;
+        prec->dpvt = (void*)pvt;
+
+        return 0;
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", prec->name, e.what());
+        return -1;
+    }
+}
+
+#define TRY \
+    if(!prec->dpvt) { \
+            recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "No Init"); \
+            return -1; \
+    } \
+    auto pvt = static_cast<ModelDev*>(prec->dpvt); \
+    try
+
+#define CATCH \
+    catch(std::exception& e){ \
+        recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "%s", e.what()); \
+        if(prec->tpro) \
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", prec->name, e.what()); \
+        return -1; \
+}
+
+long clockModelSample(aoRecord *prec) noexcept
+{
+    auto mono = epicsMonotonicGet();
+
+    // TIME of the device read, through TSEL.  Normally set after write_ao()
+    recGblGetTimeStamp(prec);
+    {
+        // back date to completion of the read, when recent
+        epicsTimeStamp wall;
+        if(epicsTimeGetCurrent(&wall)==epicsTimeOK) {
+            double delay = epicsTimeDiffInSeconds(&wall, &prec->time);
+            if(delay>0.0 && delay<1.0)
+                mono -= uint64_t(delay*1e9);
+        }
+    }
+
+    if(!isfinite(prec->val)) {
+        recGblSetSevrMsg(prec, WRITE_ALARM, INVALID_ALARM, "Out of range");
+        return -1;
+    }
+
+    TRY {
+        auto dev = pvt->epoch + llround(prec->val*1e9);
+        if(dev<=0) {
+            recGblSetSevrMsg(prec, WRITE_ALARM, INVALID_ALARM, "Out of range");
+            return -1;
+        }
+
+        auto model = pvt->model;
+        Guard G(model->lock);
+
+        model->add(mono, dev);
+
+        return 0;
+    } CATCH
+}
+
+long clockModelRead(aiRecord *prec) noexcept
+{
+    TRY {
+        auto model = pvt->model;
+        Guard G(model->lock);
+
+        if(pvt->stat==ModelDev::N) {
+            prec->val = model->samples.size();
+            return 2;
+
+        } else if(!model->valid) {
+            recGblSetSevrMsg(prec, READ_ALARM, INVALID_ALARM, "No fit");
+            return -1;
+        }
+
+        double err;
+        auto now = model->predict(epicsMonotonicGet(), &err);
+
+        switch(pvt->stat) {
+        case ModelDev::Now:
+            prec->val = now*1e-9;
+            if(prec->tse==epicsTimeEventDeviceTime)
+                toTimeStamp(&prec->time, now);
+            break;
+        case ModelDev::Err:
+            prec->val = err;
+            break;
+        case ModelDev::Rate:
+            prec->val = model->b;
+            break;
+        case ModelDev::Lag:
+            prec->val = model->ppsLag;
+            break;
+        case ModelDev::N:
+            break;
+        }
+
+        return 2; // no conversion
+    } CATCH
+}
+
+aodset devClockModelSample = {
+    {5, nullptr, nullptr, clockModelInitRecord, nullptr},
+    clockModelSample, nullptr,
+};
+aidset devClockModel = {
+    {6, nullptr, nullptr, clockModelInitRecord, nullptr},
+    clockModelRead, nullptr,
+};
+
+// only one generalTime current time provider per process
+ClockModel* provider;
+
+int clockModelTimeGet(epicsTimeStamp *pDest)
+{
+    double err;
+    if(!clockModelNow(provider, pDest, &err))
+        return epicsTimeERROR; // defer to lower priority provider
+    return epicsTimeOK;
+}
+
+void clockModelTimeProvider(const char *modelName, int priority)
+{
+    try {
+        if(!modelName || !modelName[0])
+            throw std::runtime_error("Missing model name");
+        if(provider)
+            throw std::runtime_error("Clock model time provider already registered");
+
+        provider = clockModelGetCreate(modelName);
+
+        if(generalTimeRegisterCurrentProvider("ClockModel", priority, clockModelTimeGet))
+            throw std::runtime_error("Unable to register generalTime provider");
+
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", __func__, e.what());
+    }
+}
+
+const iocshArg clockModelTimeProviderArg0 = {"model", iocshArgString};
+const iocshArg clockModelTimeProviderArg1 = {"priority", iocshArgInt};
+const iocshArg * const clockModelTimeProviderArgs[] = {&clockModelTimeProviderArg0, &clockModelTimeProviderArg1};
+const iocshFuncDef clockModelTimeProviderDef = {"clockModelTimeProvider", 2, clockModelTimeProviderArgs,
+                                                "Use named clock model as generalTime current time provider.\n"
+                                                "Falls back to lower priority providers until the model is fit.\n"};
+
+void clockModelTimeProviderCall(const iocshArgBuf *args)
+{
+    clockModelTimeProvider(args[0].sval, args[1].ival);
+}
+
+void clockModelRegistrar()
+{
+    iocshRegister(&clockModelTimeProviderDef, clockModelTimeProviderCall);
+}
+
+} // namespace
+
+namespace ospreyTiming {
+
+ClockModel* clockModelFind(const std::string& name)
+{
+    Guard G(modelsLock);
+    auto it = models.find(name);
+    return it==models.end() ? nullptr : it->second.get();
+}
+
+bool clockModelNow(ClockModel* model, epicsTimeStamp* now, double* err)
+{
+    auto mono = epicsMonotonicGet();
+    Guard G(model->lock);
+    if(!model->valid)
+        return false;
+    toTimeStamp(now, model->predict(mono, err));
+    return true;
+}
+
+} // namespace ospreyTiming
+
+extern "C" {
+epicsExportAddress(dset, devClockModelSample);
+epicsExportAddress(dset, devClockModel);
+epicsExportRegistrar(clockModelRegistrar);
+}
@@ -0,0 +1,31 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* Host side model of device time, internal interface
+ *
+ * cf. clockModel.cpp
+ */
+#ifndef CLOCKMODEL_H
+#define CLOCKMODEL_H
+
+#include <string>
+
+#include <epicsTime.h>
+
+namespace ospreyTiming {
+
+struct ClockModel;
+
+// Find named model, or nullptr
+ClockModel* clockModelFind(const std::string& name);
+
+/* Interpolate device time at the current host monotonic time.
+ * Returns false until enough samples have been accumulated.
+ * *err is the one sigma uncertainty in seconds.
+ */
+bool clockModelNow(ClockModel* model, epicsTimeStamp* now, double* err);
+
+} // namespace ospreyTiming
+
+#endif // CLOCKMODEL_H
@@ -0,0 +1,389 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* Event code coincidence detector
+ *
+ * Observe an EventLog for code A followed by code B within a time window.
+ *
+ * Output:
+ *   - matched/unmatched counts, last B-A delay (longin)
+ *   - histogram of B-A delays (aai)
+ */
+
+#include <map>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+
+#include <stdint.h>
+#include <string.h>
+
+#define USE_TYPED_DRVET
+#define USE_TYPED_RSET
+#define USE_TYPED_DSET
+
+#include <epicsTypes.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsString.h>
+#include <epicsStdio.h>
+#include <epicsTime.h>
+#include <errlog.h>
+
+#include <alarm.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <devSup.h>
+#include <recGbl.h>
+#include <dbCommon.h>
+#include <aaiRecord.h>
+#include <longoutRecord.h>
+#include <longinRecord.h>
+#include <menuFtype.h>
+
+#include <epicsExport.h>
+
+#include "eventTable.h"
+#include "scanShard.h"
+
+namespace {
+using namespace ospreyTiming;
+
+typedef epicsGuard<epicsMutex> Guard;
+
+struct Coincidence;
+
+epicsMutex coincidencesLock;
+std::map<std::string, std::unique_ptr<Coincidence>> coincidences;
+
+struct Coincidence : public EventLogObserver {
+    const uint8_t a, b;
+    const uint64_t window; // ns
+    ShardScan onChange; // on the shard of the EventLog
+
+    epicsMutex lock;
+
+    bool armed = false; // A seen, waiting for B
+    epicsTimeStamp tA;
+    epicsTimeStamp tLast; // time of last match
+
+    uint32_t nMatched=0u;
+    uint32_t nMissA=0u; // A not followed by B within window
+    uint32_t nMissB=0u; // B without preceding A
+    int64_t lastDelay=-1; // ns
+    std::vector<uint32_t> hist; // B-A delay.  [0, window] in hist.size() bins
+
+    unsigned changing=0u; // onChange scan priority mask in progress, for rate limiting
+
+    Coincidence(const std::string& logName, uint8_t a, uint8_t b, uint64_t window, size_t nbins)
+        :a(a), b(b), window(window)
+        ,hist(nbins, 0u)
+    {
+        tA.secPastEpoch = tA.nsec = 0u;
+        tLast = tA;
+        shardScanInit(onChange, scanShardFor(logName), onChangeComplete, this);
+    }
+    virtual ~Coincidence() {}
+
+    virtual void onEvents(const EventRec* recs, size_t nrecs) override final
+    {
+        Guard G(lock);
+        bool changed = false;
+
+        for(size_t i=0u; i<nrecs; i++) {
+            auto& rec = recs[i];
+            if(rec.code!=a && rec.code!=b)
+                continue;
+
+            if(armed) {
+                auto dly = diffNS(rec.ts, tA);
+                if(dly<0) {
+                    // out of order input, before the armed A.  Can not pair
+                    if(rec.code==b)
+                        nMissB++;
+                    else
+                        nMissA++;
+                    changed = true;
+                    continue;
+
+                } else if(uint64_t(dly) > window) {
+                    // expired
+                    nMissA++;
+                    armed = false;
+                    changed = true;
+                }
+            }
+
+            if(rec.code==b) {
+                if(armed) {
+                    auto dly = diffNS(rec.ts, tA);
+                    nMatched++;
+                    lastDelay = dly;
+                    tLast = rec.ts;
+                    hist[size_t(uint64_t(dly)*hist.size()/(window+1u))]++;
+                    armed = false;
+                } else {
+                    nMissB++;
+                }
+                changed = true;
+            }
+
+            if(rec.code==a) {
+                if(armed)
+                    nMissA++; // A again before B
+                armed = true;
+                tA = rec.ts;
+                changed = true;
+            }
+        }
+
+        if(changed && !changing)
+            changing = shardScanRequest(onChange);
+    }
+
+    static
+    void onChangeComplete(void *usr, IOSCANPVT, int prio) noexcept
+    {
+        auto self=static_cast<Coincidence*>(usr);
+        try {
+            unsigned mask = 1u<<prio;
+            Guard G(self->lock);
+            assert(self->changing & mask);
+            self->changing &= ~mask;
+
+        }catch(std::exception& e){
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", __func__, e.what());
+        }
+    }
+};
+
+struct CoincDev {
+    dbCommon* const prec;
+    Coincidence* const coinc;
+
+    enum stat_t {
+        Matched, MissA, MissB, Delay,
+    } stat = Matched;
+
+    CoincDev(dbCommon *prec, Coincidence* coinc)
+        :prec(prec), coinc(coinc)
+    {}
+};
+
+long coincInitRecord(dbCommon *prec) noexcept {
+    try {
+        auto plink(dbGetDevLink(prec));
+        assert(plink->type==INST_IO);
+        std::string lstr(plink->value.instio.string);
+
+
+        std::string logName;
+        int a = -1, b = -1;
+        uint64_t window = 0u;
+        size_t nbins = 64u;
+        CoincDev::stat_t stat = CoincDev::Matched;
+
+        char *saved = nullptr;
+        for(char* word = epicsStrtok_r((char*)lstr.data(), " ", &saved)
+             ; word
+             ; word = epicsStrtok_r(NULL, " ", &saved))
+        {
+            auto wlen = strlen(word);
+
+            auto cmd = [=](const char *pref) -> const char* {
+                auto plen = strlen(pref);
+                if(wlen >= plen && memcmp(word, pref, plen)==0) {
+                    return word + plen;
+                }
+                return nullptr;
+            };
+
+            if(auto val = cmd("log=")) {
+                logName = val;
+
+            } else if(auto val = cmd("a=")) {
+                a = std::stoi(val, nullptr, 0);
+
+            } else if(auto val = cmd("b=")) {
+                b = std::stoi(val, nullptr, 0);
+
+            } else if(auto val = cmd("window=")) {
+                window = std::stoull(val, nullptr, 0);
+
+            } else if(auto val = cmd("bins=")) {
+                nbins = std::stoul(val, nullptr, 0);
+
+            } else if(auto val = cmd("stat=")) {
+                if(epicsStrCaseCmp(val, "matched")==0) {
+                    stat = CoincDev::Matched;
+                } else if(epicsStrCaseCmp(val, "missA")==0) {
+                    stat = CoincDev::MissA;
+                } else if(epicsStrCaseCmp(val, "missB")==0) {
+                    stat = CoincDev::MissB;
+                } else if(epicsStrCaseCmp(val, "delay")==0) {
+                    stat = CoincDev::Delay;
+                } else {
+                    throw std::runtime_error("stat= must be 'matched', 'missA', 'missB', or 'delay'");
+                }
+
+            } else {
+                throw std::runtime_error("Unexpected dev. link parameter");
+            }
+        }
+
+        if(logName.empty())
+            throw std::runtime_error("Missing log=");
+        if(a<1 || a>255 || b<1 || b>255)
+            throw std::runtime_error("a= and b= must be event codes 1-255");
+        if(!window)
+            throw std::runtime_error("Missing window=");
+        if(!nbins)
+            throw std::runtime_error("bins= must be >0");
+
+        // records with identical configuration share one detector
+        std::string key(logName+" "+std::to_string(a)+" "+std::to_string(b)
+                        +" "+std::to_string(window)+" "+std::to_string(nbins));
+
+        Coincidence* coinc;
+        {
+            Guard G(coincidencesLock);
+            auto& ent = coincidences[key];
+            if(!ent) {
+                ent.reset(new Coincidence(logName, a, b, window, nbins));
+                eventLogAttach(logName, ent.get());
+            }
+            coinc = ent.get();
+        }
+
+        auto pvt = new CoincDev(prec, coinc);
+        pvt->stat = stat;
+        prec->dpvt = (void*)pvt;
+
+        return 0;
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", prec->name, e.what());
+        return -1;
+    }
+}
+
+long coincChanged(int detach, struct dbCommon *prec, IOSCANPVT* pscan) noexcept
+{
+    (void)detach;
+    auto pvt = static_cast<CoincDev*>(prec->dpvt);
+    if(!pvt)
+        return -1;
+
+    *pscan = pvt->coinc->onChange.scan;
+    return 0;
+}
+
+#define TRY \
+    if(!prec->dpvt) { \
+            recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "No Init"); \
+            return -1; \
+    } \
+    auto pvt = static_cast<CoincDev*>(prec->dpvt); \
+    try
+
+#define CATCH \
+    catch(std::exception& e){ \
+        recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "%s", e.what()); \
+        if(prec->tpro) \
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", prec->name, e.what()); \
+        return -1; \
+}
+
+long coincStat(longinRecord *prec) noexcept
+{
+    TRY {
+        auto coinc = pvt->coinc;
+        Guard G(coinc->lock);
+
+        switch(pvt->stat) {
+        case CoincDev::Matched:
+            prec->val = epicsInt32(coinc->nMatched);
+            break;
+        case CoincDev::MissA:
+            prec->val = epicsInt32(coinc->nMissA);
+            break;
+        case CoincDev::MissB:
+            prec->val = epicsInt32(coinc->nMissB);
+            break;
+        case CoincDev::Delay:
+            prec->val = epicsInt32(std::min(coinc->lastDelay, int64_t(0x7fffffff)));
+            break;
+        }
+        prec->time = coinc->tLast;
+
+        return 0;
+    } CATCH
+}
+
+long coincHist(aaiRecord *prec) noexcept
+{
+    if(prec->ftvl!=menuFtypeULONG) {
+        recGblSetSevrMsg(prec, READ_ALARM, INVALID_ALARM, "Bad FTVL");
+        return -1;
+    }
+
+    auto val = static_cast<epicsUInt32*>(prec->bptr);
+
+    TRY {
+        auto coinc = pvt->coinc;
+        Guard G(coinc->lock);
+
+        epicsUInt32 n = std::min(size_t(prec->nelm), coinc->hist.size());
+        std::copy(coinc->hist.begin(), coinc->hist.begin()+n, val);
+        prec->nord = n;
+        prec->time = coinc->tLast;
+
+        return 0;
+    } CATCH
+}
+
+long coincReset(longoutRecord *prec) noexcept
+{
+    TRY {
+        auto coinc = pvt->coinc;
+        {
+            Guard G(coinc->lock);
+
+            if(!prec->val)
+                return 0;
+
+            coinc->armed = false;
+            coinc->nMatched = coinc->nMissA = coinc->nMissB = 0u;
+            coinc->lastDelay = -1;
+            std::fill(coinc->hist.begin(), coinc->hist.end(), 0u);
+
+            if(!coinc->changing)
+                coinc->changing = shardScanRequest(coinc->onChange);
+        }
+
+        return 0;
+    } CATCH
+}
+
+longindset devEventCoincStat = {
+    {5, nullptr, nullptr, coincInitRecord, coincChanged},
+    coincStat,
+};
+aaidset devEventCoincHist = {
+    {5, nullptr, nullptr, coincInitRecord, coincChanged},
+    coincHist,
+};
+longoutdset devEventCoincReset = {
+    {5, nullptr, nullptr, coincInitRecord, nullptr},
+    coincReset,
+};
+
+} // namespace
+
+extern "C" {
+epicsExportAddress(dset, devEventCoincStat);
+epicsExportAddress(dset, devEventCoincHist);
+epicsExportAddress(dset, devEventCoincReset);
+}
@@ -0,0 +1,552 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* PVA monitor stream of decoded events from an EventLog.  Requires PVXS.
+ *
+ *   eventPvaStream("EVR1:EVT:STREAM", "EVR1:LOG", "100,101", 8, 8192)
+ *
+ * before iocInit.  Each update is an NTTable of the (code, sec, ns) of
+ * the events since the previous update, plus a batch sequence number,
+ * and the count of events dropped on ingest.
+ *
+ * Ingest only copies events into a lock-free queue.  A dedicated thread
+ * batches and posts to each subscriber.  A subscriber with a full queue
+ * (the lesser of depth, and the client's queueSize) misses that batch,
+ * which shows as a gap in seq.  So a slow client can not stall ingest,
+ * or other clients.  Clients should request record[pipeline=true].
+ *
+ * Output:
+ *   - event, batch, drop, and squash counts, subscribers, and rate (ai)
+ */
+
+#include <map>
+#include <set>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <pvxs/server.h>
+#include <pvxs/source.h>
+#include <pvxs/data.h>
+#include <pvxs/iochooks.h>
+
+#define USE_TYPED_RSET
+#define USE_TYPED_DSET
+
+#include <epicsTypes.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsEvent.h>
+#include <epicsThread.h>
+#include <epicsString.h>
+#include <epicsStdio.h>
+#include <epicsTime.h>
+#include <epicsMonotonic.h>
+#include <initHooks.h>
+#include <iocsh.h>
+#include <errlog.h>
+
+#include <alarm.h>
+#include <dbAccess.h>
+#include <devSup.h>
+#include <recGbl.h>
+#include <dbCommon.h>
+#include <aiRecord.h>
+
+#include <epicsExport.h>
+
+#include "eventTable.h"
+
+namespace {
+using namespace ospreyTiming;
+using namespace pvxs;
+
+typedef epicsGuard<epicsMutex> Guard;
+
+// events per update
+constexpr size_t maxBatch = 1024u;
+
+struct EventPvaStream : public EventLogObserver, public epicsThreadRunable {
+    const std::string name;
+    const std::vector<bool> codes;
+    const size_t depth; // per subscriber
+    Value prototype;
+
+    /* single producer (onEvents(), EventLog lock held)
+     * single consumer (worker)
+     */
+    std::vector<EventRec> ring;
+    const uint64_t mask; // capacity-1
+    std::atomic<uint64_t> wr{0u}, rd{0u};
+
+    struct Subscriber {
+        std::shared_ptr<server::MonitorSetupOp> setup;
+        std::shared_ptr<server::MonitorControlOp> op;
+    };
+    epicsMutex subsLock;
+    // guarded by subsLock
+    std::map<const server::MonitorSetupOp*, Subscriber> subs;
+
+    // statistics
+    std::atomic<uint64_t> nEvents{0u}, nBatches{0u}, nDropped{0u}, nSquashed{0u};
+    std::atomic<uint32_t> nSubscribers{0u};
+
+    std::atomic<uint64_t> batchSeq{0u};
+
+    epicsEvent wakeup;
+    epicsThread worker;
+
+    EventPvaStream(const std::string& name, const std::vector<bool>& codes,
+                   size_t depth, uint32_t capacity)
+        :name(name)
+        ,codes(codes)
+        ,depth(depth)
+        ,ring(capacity)
+        ,mask(capacity-1u)
+        ,worker(*this, ("PVA:" + name).c_str(),
+                epicsThreadGetStackSize(epicsThreadStackSmall),
+                epicsThreadPriorityMedium)
+    {
+        using namespace pvxs::members;
+        prototype = TypeDef(TypeCode::Struct, "epics:nt/NTTable:1.0", {
+                                StringA("labels"),
+                                Struct("value", {
+                                    UInt8A("code"),
+                                    UInt32A("sec"),
+                                    UInt32A("ns"),
+                                }),
+                                UInt64("seq"),
+                                UInt64("dropped"),
+                                Struct("timeStamp", "time_t", {
+                                    Int64("secondsPastEpoch"),
+                                    Int32("nanoseconds"),
+                                    Int32("userTag"),
+                                }),
+                            }).create();
+        shared_array<std::string> labels({"code", "sec", "ns"});
+        prototype["labels"] = labels.freeze();
+    }
+    virtual ~EventPvaStream() {}
+
+    virtual void onEvents(const EventRec* evts, size_t nevts) override final
+    {
+        auto w = wr.load(std::memory_order_relaxed);
+        auto r = rd.load(std::memory_order_acquire);
+        bool any = false;
+
+        for(size_t i=0u; i<nevts; i++) {
+            if(!codes[evts[i].code])
+                continue;
+            if(w - r > mask) {
+                r = rd.load(std::memory_order_acquire);
+                if(w - r > mask) {
+                    nDropped.fetch_add(1u, std::memory_order_relaxed);
+                    continue;
+                }
+            }
+            ring[w & mask] = evts[i];
+            w++;
+            any = true;
+        }
+
+        wr.store(w, std::memory_order_release);
+        if(any)
+            wakeup.trigger();
+    }
+
+    // with no events.  For the initial update of a new subscriber
+    Value current() const
+    {
+        auto val(prototype.clone());
+        val["seq"] = batchSeq.load();
+        val["dropped"] = nDropped.load(std::memory_order_relaxed);
+        return val;
+    }
+
+    void post(Value&& val)
+    {
+        Guard G(subsLock);
+        for(auto& pair : subs) {
+            auto& op = pair.second.op;
+
+            server::MonitorStat st;
+            op->stats(st);
+            size_t limit = depth;
+            if(st.limitQueue && st.limitQueue < limit)
+                limit = st.limitQueue;
+
+            if(st.nQueue >= limit) {
+                // slow subscriber misses this batch
+                nSquashed.fetch_add(1u, std::memory_order_relaxed);
+                continue;
+            }
+            Value copy(val);
+            op->post(std::move(copy));
+        }
+    }
+
+    void run() override final
+    {
+        while(true) {
+            wakeup.wait();
+
+            auto r = rd.load(std::memory_order_relaxed);
+            auto w = wr.load(std::memory_order_acquire);
+
+            while(r!=w) {
+                size_t n = std::min(size_t(w - r), maxBatch);
+
+                shared_array<uint8_t> code(n);
+                shared_array<uint32_t> sec(n), ns(n);
+                auto& first = ring[r & mask];
+                epicsTimeStamp ts0 = first.ts;
+
+                for(size_t i=0u; i<n; i++, r++) {
+                    auto& evt = ring[r & mask];
+                    code[i] = evt.code;
+                    sec[i] = evt.ts.secPastEpoch + POSIX_TIME_AT_EPICS_EPOCH;
+                    ns[i] = evt.ts.nsec;
+                }
+                // release slots before (slow) encode and post
+                rd.store(r, std::memory_order_release);
+
+                auto val(prototype.clone());
+                val["value.code"] = code.freeze();
+                val["value.sec"] = sec.freeze();
+                val["value.ns"] = ns.freeze();
+                val["seq"] = ++batchSeq;
+                val["dropped"] = nDropped.load(std::memory_order_relaxed);
+                val["timeStamp.secondsPastEpoch"] = ts0.secPastEpoch + POSIX_TIME_AT_EPICS_EPOCH;
+                val["timeStamp.nanoseconds"] = ts0.nsec;
+
+                post(std::move(val));
+
+                nEvents.fetch_add(n, std::memory_order_relaxed);
+                nBatches.fetch_add(1u, std::memory_order_relaxed);
+
+                w = wr.load(std::memory_order_acquire);
+            }
+        }
+    }
+
+    void onSubscribe(std::unique_ptr<server::MonitorSetupOp>&& op)
+    {
+        std::shared_ptr<server::MonitorSetupOp> setup(std::move(op));
+        auto key = setup.get();
+
+        setup->onClose([this, key](const std::string&) {
+            Guard G(subsLock);
+            if(subs.erase(key))
+                nSubscribers.fetch_sub(1u, std::memory_order_relaxed);
+        });
+
+        std::shared_ptr<server::MonitorControlOp> ctrl(setup->connect(prototype));
+
+        Guard G(subsLock);
+        auto& sub = subs[key];
+        sub.setup = setup;
+        sub.op = ctrl;
+        nSubscribers.fetch_add(1u, std::memory_order_relaxed);
+
+        ctrl->post(current());
+    }
+};
+
+struct EventPvaSource : public server::Source {
+    epicsMutex lock;
+    // guarded by lock.  Never free'd
+    std::map<std::string, EventPvaStream*> streams;
+    std::shared_ptr<const std::set<std::string>> names;
+
+    EventPvaSource()
+        :names(std::make_shared<std::set<std::string>>())
+    {}
+    virtual ~EventPvaSource() {}
+
+    EventPvaStream* find(const std::string& name)
+    {
+        Guard G(lock);
+        auto it(streams.find(name));
+        return it==streams.end() ? nullptr : it->second;
+    }
+
+    void add(EventPvaStream* stream)
+    {
+        Guard G(lock);
+        if(streams.find(stream->name)!=streams.end())
+            throw std::runtime_error("Name already in use");
+        streams[stream->name] = stream;
+
+        auto next(std::make_shared<std::set<std::string>>(*names));
+        next->insert(stream->name);
+        names = next;
+    }
+
+    virtual void onSearch(Search& op) override final
+    {
+        for(auto& pv : op) {
+            if(find(pv.name()))
+                pv.claim();
+        }
+    }
+
+    virtual void onCreate(std::unique_ptr<server::ChannelControl>&& op) override final
+    {
+        auto stream = find(op->name());
+        if(!stream)
+            return;
+
+        std::shared_ptr<server::ChannelControl> chan(std::move(op));
+
+        chan->onOp([stream](std::unique_ptr<server::ConnectOp>&& op) {
+            op->onGet([](std::unique_ptr<server::ExecOp>&& eop) {
+                eop->error("Monitor only");
+            });
+            op->connect(stream->prototype);
+        });
+
+        chan->onSubscribe([stream](std::unique_ptr<server::MonitorSetupOp>&& op) {
+            stream->onSubscribe(std::move(op));
+        });
+
+        // keep alive until closed
+        chan->onClose([chan](const std::string&) mutable {
+            chan.reset();
+        });
+    }
+
+    virtual List onList() override final
+    {
+        List ret;
+        Guard G(lock);
+        ret.names = names;
+        return ret;
+    }
+};
+
+std::shared_ptr<EventPvaSource> source;
+bool iocBuilt = false;
+
+struct PvaDev {
+    EventPvaStream* const stream;
+
+    enum stat_t {
+        Events, Batches, Dropped, Squashed, Subscribers, Rate,
+    } stat = Events;
+
+    // for Rate
+    uint64_t prevEvents = 0u;
+    epicsUInt64 prevTime = 0u;
+
+    explicit PvaDev(EventPvaStream* stream)
+        :stream(stream)
+    {}
+};
+
+long eventPvaInitRecord(dbCommon *prec) noexcept {
+    try {
+        auto plink(dbGetDevLink(prec));
+        assert(plink->type==INST_IO);
+        std::string lstr(plink->value.instio.string);
+
+        std::string streamName;
+        PvaDev::stat_t stat = PvaDev::Events;
+
+        char *saved = nullptr;
+        for(char* word = epicsStrtok_r((char*)lstr.data(), " ", &saved)
+             ; word
+             ; word = epicsStrtok_r(NULL, " ", &saved))
+        {
+            auto wlen = strlen(word);
+
+            auto cmd = [=](const char *pref) -> const char* {
+                auto plen = strlen(pref);
+                if(wlen >= plen && memcmp(word, pref, plen)==0) {
+                    return word + plen;
+                }
+                return nullptr;
+            };
+
+            if(auto val = cmd("stream=")) {
+                streamName = val;
+
+            } else if(auto val = cmd("stat=")) {
+                if(epicsStrCaseCmp(val, "events")==0) {
+                    stat = PvaDev::Events;
+                } else if(epicsStrCaseCmp(val, "batches")==0) {
+                    stat = PvaDev::Batches;
+                } else if(epicsStrCaseCmp(val, "dropped")==0) {
+                    stat = PvaDev::Dropped;
+                } else if(epicsStrCaseCmp(val, "squashed")==0) {
+                    stat = PvaDev::Squashed;
+                } else if(epicsStrCaseCmp(val, "subscribers")==0) {
+                    stat = PvaDev::Subscribers;
+                } else if(epicsStrCaseCmp(val, "rate")==0) {
+                    stat = PvaDev::Rate;
+                } else {
+                    throw std::runtime_error("stat= must be 'events', 'batches', 'dropped', 'squashed', 'subscribers', or 'rate'");
+                }
+
+            } else {
+                throw std::runtime_error("Unexpected dev. link parameter");
+            }
+        }
+
+        if(streamName.empty())
+            throw std::runtime_error("Missing stream=");
+
+        auto stream = source ? source->find(streamName) : nullptr;
+        if(!stream)
+            throw std::runtime_error("No such stream.  cf. eventPvaStream()");
+
+        auto pvt = new PvaDev(stream);
+        pvt->stat = stat;
+        pvt->prevTime = epicsMonotonicGet();
+        prec->dpvt = (void*)pvt;
+
+        return 0;
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", prec->name, e.what());
+        return -1;
+    }
+}
+
+long eventPvaRead(aiRecord *prec) noexcept
+{
+    if(!prec->dpvt) {
+        recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "No Init");
+        return -1;
+    }
+    auto pvt = static_cast<PvaDev*>(prec->dpvt);
+    auto stream = pvt->stream;
+
+    switch(pvt->stat) {
+    case PvaDev::Events: prec->val = stream->nEvents.load(); break;
+    case PvaDev::Batches: prec->val = stream->nBatches.load(); break;
+    case PvaDev::Dropped: prec->val = stream->nDropped.load(); break;
+    case PvaDev::Squashed: prec->val = stream->nSquashed.load(); break;
+    case PvaDev::Subscribers: prec->val = stream->nSubscribers.load(); break;
+    case PvaDev::Rate: {
+        // events per second since previous read
+        auto now = epicsMonotonicGet();
+        auto nevts = stream->nEvents.load();
+        double dT = (now - pvt->prevTime)*1e-9;
+        prec->val = dT>0.0 ? (nevts - pvt->prevEvents)/dT : 0.0;
+        pvt->prevEvents = nevts;
+        pvt->prevTime = now;
+    }
+        break;
+    }
+
+    return 2; // no conversion
+}
+
+aidset devEventPvaStat = {
+    {6, nullptr, nullptr, eventPvaInitRecord, nullptr},
+    eventPvaRead, nullptr,
+};
+
+void eventPvaStream(const char *name, const char *logName, const char *codeList,
+                    int depth, int capacity)
+{
+    try {
+        if(!name || !name[0])
+            throw std::runtime_error("Missing PV name");
+        if(!logName || !logName[0])
+            throw std::runtime_error("Missing log name");
+        if(iocBuilt)
+            throw std::runtime_error("Must be called before iocInit");
+        if(depth<=0)
+            depth = 8;
+        if(capacity<=0)
+            capacity = 8192;
+        if(capacity & (capacity-1))
+            throw std::runtime_error("capacity must be a power of 2");
+
+        std::vector<bool> codes(256u, true);
+        if(codeList && codeList[0]) {
+            codes.assign(256u, false);
+
+            std::string list(codeList);
+            size_t pos = 0u;
+            while(pos < list.size()) {
+                auto sep = list.find(',', pos);
+                if(sep==std::string::npos)
+                    sep = list.size();
+                auto code = std::stoi(list.substr(pos, sep-pos), nullptr, 0);
+                if(code<1 || code>255)
+                    throw std::runtime_error("event codes must be 1-255");
+                codes[code] = true;
+                pos = sep+1u;
+            }
+        }
+
+        if(!source)
+            source = std::make_shared<EventPvaSource>();
+
+        std::unique_ptr<EventPvaStream> stream(new EventPvaStream(name, codes, depth, capacity));
+        source->add(stream.get());
+        auto pstream = stream.release(); // never free'd
+        pstream->worker.start();
+
+        eventLogAttach(logName, pstream);
+
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", __func__, e.what());
+    }
+}
+
+void eventPvaInitHook(initHookState state)
+{
+    if(state!=initHookAfterIocBuilt)
+        return;
+    iocBuilt = true;
+
+    if(source) {
+        try {
+            ioc::server().addSource("ospreyTiming", source);
+        } catch(std::exception& e){
+            errlogPrintf("%s " ERL_ERROR ": %s\n", __func__, e.what());
+        }
+    }
+}
+
+const iocshArg eventPvaStreamArg0 = {"PV name", iocshArgString};
+const iocshArg eventPvaStreamArg1 = {"log", iocshArgString};
+const iocshArg eventPvaStreamArg2 = {"event codes", iocshArgString};
+const iocshArg eventPvaStreamArg3 = {"depth", iocshArgInt};
+const iocshArg eventPvaStreamArg4 = {"capacity", iocshArgInt};
+const iocshArg * const eventPvaStreamArgs[] = {
+    &eventPvaStreamArg0, &eventPvaStreamArg1, &eventPvaStreamArg2,
+    &eventPvaStreamArg3, &eventPvaStreamArg4,
+};
+const iocshFuncDef eventPvaStreamDef = {"eventPvaStream", 5, eventPvaStreamArgs,
+                                        "Serve events of named Event Table log as a PVA monitor stream.\n"
+                                        "Optional comma separated list of event codes, default all.\n"
+                                        "Per subscriber queue depth, default 8.\n"
+                                        "Ingest queue capacity is a power of 2, default 8192.\n"};
+
+void eventPvaStreamCall(const iocshArgBuf *args)
+{
+    eventPvaStream(args[0].sval, args[1].sval, args[2].sval, args[3].ival, args[4].ival);
+}
+
+void eventPvaRegistrar()
+{
+    iocshRegister(&eventPvaStreamDef, eventPvaStreamCall);
+    initHookRegister(eventPvaInitHook);
+}
+
+} // namespace
+
+extern "C" {
+epicsExportAddress(dset, devEventPvaStat);
+epicsExportRegistrar(eventPvaRegistrar);
+}
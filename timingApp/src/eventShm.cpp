@@ -0,0 +1,219 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* Shared memory export of decoded events from an EventLog
+ *
+ * Writer side of the ring described in eventShm.h
+ *
+ *   eventShmExport("LOGNAME", "/osprey-evr1", 4096, "")        # all events
+ *   eventShmExport("LOGNAME", "/osprey-evr1-trig", 256, "100,101")
+ *
+ * before iocInit.
+ */
+
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <epicsTypes.h>
+#include <epicsStdio.h>
+#include <epicsTime.h>
+#include <iocsh.h>
+#include <errlog.h>
+
+#include <epicsExport.h>
+
+#include "eventTable.h"
+#include "eventShm.h"
+
+namespace {
+using namespace ospreyTiming;
+
+struct EventShmExport : public EventLogObserver {
+    const std::string shmName;
+    eventShmHeader *hdr = nullptr;
+    eventShmRecord *recs = nullptr;
+    size_t size = 0u;
+    uint64_t mask = 0u; // capacity-1
+    uint64_t seq = 0u;  // last written
+    std::vector<bool> codes;
+
+    EventShmExport(const std::string& shmName, const std::string& logName,
+                   uint32_t capacity, const std::vector<bool>& codes)
+        :shmName(shmName)
+        ,codes(codes)
+    {
+        if(!capacity || (capacity & (capacity-1u)))
+            throw std::runtime_error("capacity must be a power of 2");
+
+        size = sizeof(eventShmHeader) + capacity*sizeof(eventShmRecord);
+
+        // readers of a previous ring must not see it re-initialized in place
+        uint32_t generation = retire(shmName);
+
+        int fd = shm_open(shmName.c_str(), O_RDWR|O_CREAT|O_EXCL, 0644);
+        if(fd<0)
+            throw std::runtime_error("shm_open(" + shmName + ") : " + strerror(errno));
+
+        if(ftruncate(fd, size)) {
+            int err = errno;
+            close(fd);
+            throw std::runtime_error("ftruncate(" + shmName + ") : " + strerror(err));
+        }
+
+        void *base = mmap(nullptr, size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if(base==MAP_FAILED)
+            throw std::runtime_error("mmap(" + shmName + ") : " + strerror(errno));
+
+        hdr = static_cast<eventShmHeader*>(base);
+        recs = reinterpret_cast<eventShmRecord*>(hdr+1);
+        mask = capacity-1u;
+
+        // zero filled by ftruncate()
+        hdr->version = EVENTSHM_VERSION;
+        hdr->recordSize = sizeof(eventShmRecord);
+        hdr->capacity = capacity;
+        hdr->generation = generation;
+        strncpy(hdr->log, logName.c_str(), sizeof(hdr->log)-1u);
+        __atomic_store_n(&hdr->magic, EVENTSHM_MAGIC, __ATOMIC_RELEASE);
+    }
+    virtual ~EventShmExport() {}
+
+    /* Bump the generation of an existing ring, which its readers will notice,
+     * and unlink it.  Returns the generation for the new ring.
+     */
+    static
+    uint32_t retire(const std::string& shmName)
+    {
+        uint32_t generation = 1u;
+
+        int fd = shm_open(shmName.c_str(), O_RDWR, 0);
+        if(fd<0)
+            return generation; // none
+
+        struct stat info;
+        if(!fstat(fd, &info) && size_t(info.st_size) >= sizeof(eventShmHeader)) {
+            void *base = mmap(nullptr, sizeof(eventShmHeader), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+            if(base!=MAP_FAILED) {
+                auto old = static_cast<eventShmHeader*>(base);
+                if(__atomic_load_n(&old->magic, __ATOMIC_ACQUIRE)==EVENTSHM_MAGIC
+                        && old->version==EVENTSHM_VERSION)
+                {
+                    generation = old->generation+1u;
+                    if(!generation)
+                        generation = 1u;
+                    __atomic_store_n(&old->generation, generation, __ATOMIC_RELEASE);
+                }
+                munmap(base, sizeof(eventShmHeader));
+            }
+        }
+        close(fd);
+
+        if(shm_unlink(shmName.c_str()) && errno!=ENOENT)
+            throw std::runtime_error("shm_unlink(" + shmName + ") : " + strerror(errno));
+
+        return generation;
+    }
+
+    virtual void onEvents(const EventRec* evts, size_t nevts) override final
+    {
+        for(size_t i=0u; i<nevts; i++) {
+            auto& evt = evts[i];
+            if(!codes[evt.code])
+                continue;
+
+            auto next = seq+1u;
+            auto& rec = recs[next & mask];
+
+            __atomic_store_n(&rec.seq, 0u, __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_RELEASE);
+            rec.sec = evt.ts.secPastEpoch + POSIX_TIME_AT_EPICS_EPOCH;
+            rec.nsec = evt.ts.nsec;
+            rec.code = evt.code;
+            __atomic_store_n(&rec.seq, next, __ATOMIC_RELEASE);
+
+            seq = next;
+        }
+        // publish once per batch
+        __atomic_store_n(&hdr->head, seq, __ATOMIC_RELEASE);
+    }
+};
+
+void eventShmExport(const char *logName, const char *shmName, int capacity, const char *codeList)
+{
+    try {
+        if(!logName || !logName[0])
+            throw std::runtime_error("Missing log name");
+        if(!shmName || shmName[0]!='/')
+            throw std::runtime_error("Shared memory name must begin with '/'");
+        if(capacity<=0)
+            capacity = 4096;
+
+        std::vector<bool> codes(256u, true);
+        if(codeList && codeList[0]) {
+            codes.assign(256u, false);
+
+            std::string list(codeList);
+            size_t pos = 0u;
+            while(pos < list.size()) {
+                auto sep = list.find(',', pos);
+                if(sep==std::string::npos)
+                    sep = list.size();
+                auto code = std::stoi(list.substr(pos, sep-pos), nullptr, 0);
+                if(code<1 || code>255)
+                    throw std::runtime_error("event codes must be 1-255");
+                codes[code] = true;
+                pos = sep+1u;
+            }
+        }
+
+        std::unique_ptr<EventShmExport> exp(new EventShmExport(shmName, logName, capacity, codes));
+
+        // never free'd
+        eventLogAttach(logName, exp.release());
+
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", __func__, e.what());
+    }
+}
+
+const iocshArg eventShmExportArg0 = {"log", iocshArgString};
+const iocshArg eventShmExportArg1 = {"shm name", iocshArgString};
+const iocshArg eventShmExportArg2 = {"capacity", iocshArgInt};
+const iocshArg eventShmExportArg3 = {"event codes", iocshArgString};
+const iocshArg * const eventShmExportArgs[] = {
+    &eventShmExportArg0, &eventShmExportArg1, &eventShmExportArg2, &eventShmExportArg3,
+};
+const iocshFuncDef eventShmExportDef = {"eventShmExport", 4, eventShmExportArgs,
+                                        "Publish events of named Event Table log into a POSIX shared memory ring.\n"
+                                        "Capacity is a power of 2, default 4096.\n"
+                                        "Optional comma separated list of event codes, default all.\n"
+                                        "cf. eventShm.h\n"};
+
+void eventShmExportCall(const iocshArgBuf *args)
+{
+    eventShmExport(args[0].sval, args[1].sval, args[2].ival, args[3].sval);
+}
+
+void eventShmRegistrar()
+{
+    iocshRegister(&eventShmExportDef, eventShmExportCall);
+}
+
+} // namespace
+
+extern "C" {
+epicsExportRegistrar(eventShmRegistrar);
+}
@@ -0,0 +1,86 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* Shared memory export of decoded events.  Public interface
+ *
+ * An IOC configured with
+ *
+ *   eventShmExport("LOGNAME", "/osprey-evr1", 4096, "")
+ *
+ * publishes each event received by the named EventLog into a POSIX shared
+ * memory ring.  One writer, any number of readers.  Readers never block
+ * the writer.  A reader which falls more than one ring behind loses the
+ * overwritten events, and is told how many.
+ *
+ * Layout, native byte order:
+ *
+ *   eventShmHeader
+ *   eventShmRecord[capacity]
+ *
+ * The writer fills record (seq % capacity) by first storing seq=0, then
+ * the payload, then seq.  Then stores head=seq.  A reader copies a record
+ * between two loads of seq, and accepts it when both match the expected
+ * sequence number.  Sequence numbers start at 1.
+ *
+ * A restarted writer first bumps the generation of any existing ring, then
+ * unlinks it and creates a new one with the next generation.  Readers of
+ * the old ring then get an error, and should re-open.
+ *
+ * Readers need only this header, and the ospreyEventShm library.
+ */
+#ifndef EVENTSHM_H
+#define EVENTSHM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EVENTSHM_MAGIC 0x4f45534dul /* "OESM" */
+#define EVENTSHM_VERSION 2u
+
+typedef struct {
+    uint64_t seq;     /* 0 while being written */
+    uint32_t sec;     /* seconds since POSIX epoch */
+    uint32_t nsec;
+    uint8_t code;     /* event code */
+    uint8_t reserved[7];
+} eventShmRecord;
+
+typedef struct {
+    uint32_t magic;   /* EVENTSHM_MAGIC, written last during setup */
+    uint32_t version; /* EVENTSHM_VERSION */
+    uint32_t recordSize; /* sizeof(eventShmRecord) */
+    uint32_t capacity;   /* number of records, a power of 2 */
+    uint32_t generation; /* changed when this ring is replaced */
+    uint32_t reserved;
+    uint64_t head;    /* sequence number of newest complete record, or 0 */
+    char log[48];     /* EventLog name, nil terminated */
+} eventShmHeader;
+
+typedef struct eventShmReader eventShmReader;
+
+/* Open an existing ring by shared memory name, eg. "/osprey-evr1".
+ * Reading starts after the newest record.  Returns NULL on error.
+ */
+eventShmReader* eventShmOpen(const char *name);
+
+void eventShmClose(eventShmReader *reader);
+
+/* Copy up to 'max' new records, oldest first.  Returns the number copied,
+ * or -1 on error, including when the writer has restarted.  If not NULL,
+ * *nLost is incremented by the number of records overwritten before they
+ * could be read.
+ */
+int eventShmRead(eventShmReader *reader, eventShmRecord *recs, unsigned max, uint64_t *nLost);
+
+/* Sequence number of the newest complete record */
+uint64_t eventShmHead(const eventShmReader *reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EVENTSHM_H */
@@ -0,0 +1,149 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* Reader of the shared memory event ring.  cf. eventShm.h
+ *
+ * Plain POSIX, no dependence on EPICS Base.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "eventShm.h"
+
+struct eventShmReader {
+    eventShmHeader *hdr;
+    eventShmRecord *recs;
+    size_t size; /* of mapping */
+    uint64_t next; /* sequence number of next record to read */
+    uint32_t generation; /* of ring when opened */
+};
+
+eventShmReader* eventShmOpen(const char *name)
+{
+    eventShmReader *reader;
+    eventShmHeader *hdr;
+    struct stat info;
+    size_t size;
+    void *base;
+    int fd;
+
+    fd = shm_open(name, O_RDONLY, 0);
+    if(fd<0)
+        return NULL;
+
+    if(fstat(fd, &info) || (size_t)info.st_size < sizeof(eventShmHeader)) {
+        close(fd);
+        return NULL;
+    }
+    size = info.st_size;
+
+    base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(base==MAP_FAILED)
+        return NULL;
+
+    hdr = (eventShmHeader*)base;
+    if(__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE)!=EVENTSHM_MAGIC
+            || hdr->version!=EVENTSHM_VERSION
+            || hdr->recordSize!=sizeof(eventShmRecord)
+            || !hdr->capacity || (hdr->capacity & (hdr->capacity-1u))
+            || size < sizeof(eventShmHeader) + hdr->capacity*sizeof(eventShmRecord))
+    {
+        munmap(base, size);
+        return NULL;
+    }
+
+    reader = calloc(1, sizeof(*reader));
+    if(!reader) {
+        munmap(base, size);
+        return NULL;
+    }
+    reader->hdr = hdr;
+    reader->recs = (eventShmRecord*)(hdr+1);
+    reader->size = size;
+    reader->generation = __atomic_load_n(&hdr->generation, __ATOMIC_ACQUIRE);
+    reader->next = __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE) + 1u;
+
+    return reader;
+}
+
+void eventShmClose(eventShmReader *reader)
+{
+    if(!reader)
+        return;
+    munmap(reader->hdr, reader->size);
+    free(reader);
+}
+
+uint64_t eventShmHead(const eventShmReader *reader)
+{
+    return __atomic_load_n(&reader->hdr->head, __ATOMIC_ACQUIRE);
+}
+
+int eventShmRead(eventShmReader *reader, eventShmRecord *recs, unsigned max, uint64_t *nLost)
+{
+    uint64_t cap;
+    unsigned n = 0u;
+
+    if(!reader || (!recs && max))
+        return -1;
+    if(__atomic_load_n(&reader->hdr->generation, __ATOMIC_ACQUIRE)!=reader->generation)
+        return -1; /* writer restarted.  re-open */
+    cap = reader->hdr->capacity;
+
+    while(n < max) {
+        uint64_t head = __atomic_load_n(&reader->hdr->head, __ATOMIC_ACQUIRE);
+        const eventShmRecord *src;
+        uint64_t s1, s2;
+
+        if(reader->next > head)
+            break; /* caught up */
+
+        if(head - reader->next >= cap) {
+            /* overrun.  skip to oldest which may still be intact */
+            uint64_t oldest = head - cap + 1u;
+            if(nLost)
+                *nLost += oldest - reader->next;
+            reader->next = oldest;
+        }
+
+        src = &reader->recs[reader->next & (cap-1u)];
+
+        s1 = __atomic_load_n(&src->seq, __ATOMIC_ACQUIRE);
+        memcpy(&recs[n], src, sizeof(*src));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        s2 = __atomic_load_n(&src->seq, __ATOMIC_RELAXED);
+
+        if(s1!=reader->next || s2!=reader->next) {
+            /* Record 'next' was complete (next <= head), so any change means
+             * it has been overwritten, either fully (seq > next) or in
+             * progress (seq==0).  Count it lost and move on, without waiting
+             * on a writer which may never finish.
+             */
+            uint64_t newer = s1 > s2 ? s1 : s2;
+            uint64_t skip = 1u;
+
+            if(newer!=0u && newer < reader->next)
+                return -1; /* corrupt */
+            if(newer > reader->next && newer - reader->next >= cap)
+                skip = newer - cap + 1u - reader->next; /* skip to oldest which may be intact */
+
+            if(nLost)
+                *nLost += skip;
+            reader->next += skip;
+            continue;
+        }
+        recs[n].seq = s1;
+        reader->next++;
+        n++;
+    }
+
+    return (int)n;
+}
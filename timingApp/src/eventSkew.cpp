@@ -0,0 +1,528 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* Cross-node event arrival skew
+ *
+ * Observe the EventLog of each node for the same event codes.  Arrivals
+ * of one code on different nodes within a time window of each other are
+ * one emission instance by the EVG.  The skew of each node is the
+ * difference of its hardware timestamp from that of the reference node.
+ *
+ * An instance is complete when seen by all nodes, or abandoned once
+ * any node has seen an event more than hold= ns later.  A node which has
+ * not seen an abandoned instance counts as missed.  Instances not seen
+ * by the reference node contribute no skew.
+ *
+ * Output:
+ *   - per node last, mean, std. dev., min, max, count, missed (aai indexed by node)
+ *   - the same per node (ai)
+ */
+
+#include <map>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <deque>
+#include <algorithm>
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define USE_TYPED_RSET
+#define USE_TYPED_DSET
+
+#include <epicsTypes.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsString.h>
+#include <epicsStdio.h>
+#include <epicsTime.h>
+#include <epicsMath.h>
+#include <errlog.h>
+
+#include <alarm.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <devSup.h>
+#include <recGbl.h>
+#include <dbCommon.h>
+#include <aaiRecord.h>
+#include <aiRecord.h>
+#include <longoutRecord.h>
+#include <menuFtype.h>
+
+#include <epicsExport.h>
+
+#include "eventTable.h"
+#include "scanShard.h"
+
+namespace {
+using namespace ospreyTiming;
+
+typedef epicsGuard<epicsMutex> Guard;
+
+struct EventSkew;
+
+epicsMutex skewsLock;
+std::map<std::string, std::unique_ptr<EventSkew>> skews;
+
+// open instances.  Beyond this, the oldest is abandoned
+constexpr size_t maxOpen = 256u;
+
+struct EventSkew {
+    epicsMutex lock;
+
+    std::vector<bool> codes; // [256] empty until configured
+    int64_t window = 10000; // ns
+    int64_t hold = 1000000000; // ns
+    size_t ref = 0u;
+
+    struct Node {
+        std::string logName; // empty until attached
+
+        uint32_t missed = 0u;
+        RunningStat skew; // ns
+    };
+    std::vector<Node> nodes; // [node]
+    size_t nAttached = 0u;
+
+    struct Instance {
+        uint8_t code;
+        epicsTimeStamp t0; // first arrival
+        std::vector<epicsTimeStamp> ts; // [node]
+        std::vector<bool> seen; // [node]
+        size_t nseen = 0u;
+    };
+    std::deque<Instance> open;
+
+    bool haveNewest = false;
+    epicsTimeStamp newest;
+    epicsTimeStamp tLast; // reference time of last instance closed
+
+    ShardScan onChange; // on the shard of the first attached EventLog
+    unsigned changing=0u;
+
+    struct Observer : public EventLogObserver {
+        EventSkew* const skew;
+        const size_t node;
+        Observer(EventSkew* skew, size_t node) :skew(skew), node(node) {}
+        virtual ~Observer() {}
+        virtual void onEvents(const EventRec* recs, size_t nrecs) override final
+        {
+            Guard G(skew->lock);
+            bool closed = false;
+            for(size_t i=0u; i<nrecs; i++) {
+                if(skew->codes.empty() || !skew->codes[recs[i].code])
+                    continue;
+                closed |= skew->arrive(node, recs[i].code, recs[i].ts);
+            }
+            if(closed)
+                skew->changed();
+        }
+    };
+
+    EventSkew()
+    {
+        newest.secPastEpoch = newest.nsec = 0u;
+        tLast = newest;
+        shardScanInit(onChange, nullptr, onChangeComplete, this);
+    }
+
+    static
+    EventSkew* getCreate(const std::string& name) {
+        Guard G(skewsLock);
+        auto& ent = skews[name];
+        if(!ent)
+            ent.reset(new EventSkew);
+        return ent.get();
+    }
+
+    // must lock
+    void changed()
+    {
+        if(!changing)
+            changing = shardScanRequest(onChange);
+    }
+
+    // must lock
+    static
+    void accumulate(Node& node, double skew)
+    {
+        node.skew.add(skew);
+    }
+
+    // must lock
+    void close(const Instance& inst)
+    {
+        bool haveRef = ref < inst.seen.size() && inst.seen[ref];
+
+        for(size_t i=0u; i<nodes.size() && i<inst.seen.size(); i++) {
+            auto& node = nodes[i];
+            if(node.logName.empty())
+                continue;
+            if(!inst.seen[i])
+                node.missed++;
+            else if(haveRef)
+                accumulate(node, diffNS(inst.ts[i], inst.ts[ref]));
+        }
+        if(haveRef)
+            tLast = inst.ts[ref];
+    }
+
+    // must lock.  returns true if any instance closed
+    bool arrive(size_t idx, uint8_t code, const epicsTimeStamp& ts)
+    {
+        bool closed = false;
+
+        if(!haveNewest || diffNS(ts, newest) > 0)
+            newest = ts;
+        haveNewest = true;
+
+        // oldest open instance of this code not yet seen by this node
+        auto it(std::find_if(open.begin(), open.end(), [this, idx, code, &ts](const Instance& inst) {
+            auto dT = diffNS(ts, inst.t0);
+            return inst.code==code && !inst.seen[idx] && dT <= window && dT >= -window;
+        }));
+
+        if(it==open.end()) {
+            if(open.size() >= maxOpen) {
+                close(open.front());
+                open.pop_front();
+                closed = true;
+            }
+            open.emplace_back();
+            it = open.end()-1;
+            it->code = code;
+            it->t0 = ts;
+            it->ts.resize(nodes.size());
+            it->seen.assign(nodes.size(), false);
+        }
+
+        it->seen[idx] = true;
+        it->ts[idx] = ts;
+        if(++it->nseen >= nAttached) {
+            close(*it);
+            open.erase(it);
+            closed = true;
+        }
+
+        // abandon stale instances
+        for(auto it(open.begin()); it!=open.end();) {
+            if(diffNS(newest, it->t0) > hold) {
+                close(*it);
+                it = open.erase(it);
+                closed = true;
+            } else {
+                ++it;
+            }
+        }
+
+        return closed;
+    }
+
+    // must lock
+    void reset()
+    {
+        for(auto& node : nodes) {
+            node.missed = 0u;
+            node.skew = RunningStat();
+        }
+        changed();
+    }
+
+    static
+    void onChangeComplete(void *usr, IOSCANPVT, int prio) noexcept
+    {
+        auto self=static_cast<EventSkew*>(usr);
+        try {
+            unsigned mask = 1u<<prio;
+            Guard G(self->lock);
+            assert(self->changing & mask);
+            self->changing &= ~mask;
+
+        }catch(std::exception& e){
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", __func__, e.what());
+        }
+    }
+};
+
+struct SkewDev {
+    EventSkew* const skew;
+    long node = -1;
+
+    enum stat_t {
+        Last, Mean, Std, Min, Max, Count, Missed,
+    } stat = Mean;
+
+    explicit SkewDev(EventSkew* skew)
+        :skew(skew)
+    {}
+
+    // must lock
+    double value(const EventSkew::Node& node) const
+    {
+        double v = epicsNAN;
+        switch(stat) {
+        case Last: v = node.skew.value(RunningStat::Last); break;
+        case Mean: v = node.skew.value(RunningStat::Mean); break;
+        case Std: v = node.skew.value(RunningStat::Std); break;
+        case Min: v = node.skew.value(RunningStat::Min); break;
+        case Max: v = node.skew.value(RunningStat::Max); break;
+        case Count: v = node.skew.value(RunningStat::Count); break;
+        case Missed: v = node.missed; break;
+        }
+        return v;
+    }
+};
+
+long skewInitRecord(dbCommon *prec) noexcept {
+    try {
+        auto plink(dbGetDevLink(prec));
+        assert(plink->type==INST_IO);
+        std::string lstr(plink->value.instio.string);
+
+        std::string skewName, logName, codeList;
+        long node = -1, ref = -1;
+        int64_t window = 0, hold = 0;
+        SkewDev::stat_t stat = SkewDev::Mean;
+
+        char *saved = nullptr;
+        for(char* word = epicsStrtok_r((char*)lstr.data(), " ", &saved)
+             ; word
+             ; word = epicsStrtok_r(NULL, " ", &saved))
+        {
+            auto wlen = strlen(word);
+
+            auto cmd = [=](const char *pref) -> const char* {
+                auto plen = strlen(pref);
+                if(wlen >= plen && memcmp(word, pref, plen)==0) {
+                    return word + plen;
+                }
+                return nullptr;
+            };
+
+            if(auto val = cmd("skew=")) {
+                skewName = val;
+
+            } else if(auto val = cmd("codes=")) {
+                codeList = val;
+
+            } else if(auto val = cmd("node=")) {
+                node = std::stol(val, nullptr, 0);
+                if(node<0 || node>=1024)
+                    throw std::runtime_error("node= must be 0-1023");
+
+            } else if(auto val = cmd("ref=")) {
+                ref = std::stol(val, nullptr, 0);
+                if(ref<0 || ref>=1024)
+                    throw std::runtime_error("ref= must be 0-1023");
+
+            } else if(auto val = cmd("log=")) {
+                logName = val;
+
+            } else if(auto val = cmd("window=")) {
+                window = std::stoll(val, nullptr, 0);
+                if(window<=0)
+                    throw std::runtime_error("window= must be >0");
+
+            } else if(auto val = cmd("hold=")) {
+                hold = std::stoll(val, nullptr, 0);
+                if(hold<=0)
+                    throw std::runtime_error("hold= must be >0");
+
+            } else if(auto val = cmd("stat=")) {
+                if(epicsStrCaseCmp(val, "last")==0) {
+                    stat = SkewDev::Last;
+                } else if(epicsStrCaseCmp(val, "mean")==0) {
+                    stat = SkewDev::Mean;
+                } else if(epicsStrCaseCmp(val, "std")==0) {
+                    stat = SkewDev::Std;
+                } else if(epicsStrCaseCmp(val, "min")==0) {
+                    stat = SkewDev::Min;
+                } else if(epicsStrCaseCmp(val, "max")==0) {
+                    stat = SkewDev::Max;
+                } else if(epicsStrCaseCmp(val, "count")==0) {
+                    stat = SkewDev::Count;
+                } else if(epicsStrCaseCmp(val, "missed")==0) {
+                    stat = SkewDev::Missed;
+                } else {
+                    throw std::runtime_error("stat= must be 'last', 'mean', 'std', 'min', 'max', 'count', or 'missed'");
+                }
+
+            } else {
+                throw std::runtime_error("Unexpected dev. link parameter");
+            }
+        }
+
+        if(skewName.empty())
+            throw std::runtime_error("Missing skew=");
+        if(!logName.empty() && node<0)
+            throw std::runtime_error("log= requires node=");
+
+        std::vector<bool> codes;
+        if(!codeList.empty()) {
+            codes.assign(256u, false);
+            size_t pos = 0u;
+            while(pos < codeList.size()) {
+                auto sep = codeList.find(',', pos);
+                if(sep==std::string::npos)
+                    sep = codeList.size();
+                auto code = std::stoi(codeList.substr(pos, sep-pos), nullptr, 0);
+                if(code<1 || code>255)
+                    throw std::runtime_error("codes= must be event codes 1-255");
+                codes[code] = true;
+                pos = sep+1u;
+            }
+        }
+
+        auto skew = EventSkew::getCreate(skewName);
+        bool attach = false;
+        {
+            Guard G(skew->lock);
+
+            if(!codes.empty()) {
+                if(!skew->codes.empty() && skew->codes!=codes)
+                    throw std::runtime_error("skew= already has different codes=");
+                skew->codes = codes;
+            }
+            if(window)
+                skew->window = window;
+            if(hold)
+                skew->hold = hold;
+            if(ref>=0)
+                skew->ref = ref;
+
+            if(node>=0) {
+                if(skew->nodes.size() <= size_t(node)) {
+                    if(!skew->open.empty())
+                        throw std::runtime_error("node= must be added before events arrive");
+                    skew->nodes.resize(node+1);
+                }
+                auto& ent = skew->nodes[node];
+                if(!logName.empty()) {
+                    if(ent.logName.empty()) {
+                        ent.logName = logName;
+                        skew->nAttached++;
+                        shardScanAssign(skew->onChange, logName);
+                        attach = true;
+                    } else if(ent.logName!=logName) {
+                        throw std::runtime_error("node= already associated with different log=");
+                    }
+                }
+            }
+        }
+        // never free'd
+        if(attach)
+            eventLogAttach(logName, new EventSkew::Observer(skew, node));
+
+        auto pvt = new SkewDev(skew);
+        pvt->node = node;
+        pvt->stat = stat;
+        prec->dpvt = (void*)pvt;
+
+        return 0;
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", prec->name, e.what());
+        return -1;
+    }
+}
+
+long skewChanged(int detach, struct dbCommon *prec, IOSCANPVT* pscan) noexcept
+{
+    (void)detach;
+    auto pvt = static_cast<SkewDev*>(prec->dpvt);
+    if(!pvt)
+        return -1;
+
+    *pscan = pvt->skew->onChange.scan;
+    return 0;
+}
+
+#define TRY \
+    if(!prec->dpvt) { \
+            recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "No Init"); \
+            return -1; \
+    } \
+    auto pvt = static_cast<SkewDev*>(prec->dpvt); \
+    try
+
+#define CATCH \
+    catch(std::exception& e){ \
+        recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "%s", e.what()); \
+        if(prec->tpro) \
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", prec->name, e.what()); \
+        return -1; \
+}
+
+long skewStat(aaiRecord *prec) noexcept
+{
+    if(prec->ftvl!=menuFtypeDOUBLE) {
+        recGblSetSevrMsg(prec, READ_ALARM, INVALID_ALARM, "Bad FTVL");
+        return -1;
+    }
+
+    auto val = static_cast<double*>(prec->bptr);
+
+    TRY {
+        auto skew = pvt->skew;
+        Guard G(skew->lock);
+
+        epicsUInt32 n = 0u;
+        for(; n<prec->nelm && n<skew->nodes.size(); n++)
+            val[n] = pvt->value(skew->nodes[n]);
+        prec->nord = n;
+        prec->time = skew->tLast;
+
+        return 0;
+    } CATCH
+}
+
+long skewNode(aiRecord *prec) noexcept
+{
+    TRY {
+        auto skew = pvt->skew;
+        Guard G(skew->lock);
+
+        if(pvt->node<0 || size_t(pvt->node)>=skew->nodes.size())
+            throw std::runtime_error("No node=");
+
+        prec->val = pvt->value(skew->nodes[pvt->node]);
+        prec->time = skew->tLast;
+
+        return 2; // no conversion
+    } CATCH
+}
+
+long skewReset(longoutRecord *prec) noexcept
+{
+    TRY {
+        auto skew = pvt->skew;
+        Guard G(skew->lock);
+        skew->reset();
+        return 0;
+    } CATCH
+}
+
+aaidset devEventSkewStat = {
+    {5, nullptr, nullptr, skewInitRecord, skewChanged},
+    skewStat,
+};
+aidset devEventSkewNode = {
+    {6, nullptr, nullptr, skewInitRecord, skewChanged},
+    skewNode, nullptr,
+};
+longoutdset devEventSkewReset = {
+    {5, nullptr, nullptr, skewInitRecord, nullptr},
+    skewReset,
+};
+
+} // namespace
+
+extern "C" {
+epicsExportAddress(dset, devEventSkewStat);
+epicsExportAddress(dset, devEventSkewNode);
+epicsExportAddress(dset, devEventSkewReset);
+}
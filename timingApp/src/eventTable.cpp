@@ -8,9 +8,33 @@
  *   - event log as sequence of 3x word triples (event, sec, ticks)
  *   - sec/tick scale
  *   - Selection of event codes
+ *
+ * Several inputs may name one log.  Those with src= are held for up to a
+ * reorder window (reorder=, ns), and merged in timestamp order before
+ * dispatch.  Events older than the last dispatched are dropped as late.
+ * Inputs without src= are dispatched in arrival order.
+ *
  * Output:
  *   - RX count (ai)
  *   - RX buffer (aai)
+ *   - Pre/post trigger capture of all event codes (aai)
+ *   - Merge late, reordered, and held counts (longin)
+ *   - Per queue overflow and decimation counts (longin)
+ *
+ * Each queue may be decimated to every Nth event (every=), and/or at most
+ * K events per period (limit=, period= ns).  When full, a queue drops
+ * either the newest (default) or the oldest event (overflow=).
+ *
+ * I/O Intr scans of a queue may be limited to a maximum rate (maxrate=, Hz).
+ * Wakeups in between are coalesced, and a delayed scan always follows the
+ * last.  Counts and buffers are not affected, only the scan rate.
+ *
+ * Selected codes (dbevent=) also post DB events, for SCAN=Event records with
+ * EVNT=<code>.  Processing of such a record may measure the time since
+ * the post (Event Table DB Event Latency).
+ *
+ * dbior("drvEventTable", lvl) reports each log, and with lvl>=1 each
+ * queue.  Counters are copied under a brief lock and printed afterwards.
  */
 
 #include <map>
@@ -18,6 +42,10 @@
 #include <memory>
 #include <stdexcept>
 #include <list>
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <atomic>
 
 #include <stdint.h>
 #include <string.h>
@@ -33,6 +61,7 @@
 #include <epicsStdio.h>
 #include <epicsTime.h>
 #include <epicsMath.h>
+#include <epicsMonotonic.h>
 #include <errlog.h>
 
 #include <alarm.h>
@@ -44,6 +73,7 @@
 #include <drvSup.h>
 #include <recGbl.h>
 #include <dbCommon.h>
+#include <aiRecord.h>
 #include <aoRecord.h>
 #include <aaoRecord.h>
 #include <aaiRecord.h>
@@ -53,77 +83,986 @@
 
 #include <epicsExport.h>
 
+#include "eventTable.h"
+#include "scanShard.h"
 
 namespace {
+using namespace ospreyTiming;
 
 typedef epicsGuard<epicsMutex> Guard;
 
 struct EventLog; // entry for mux'd input event log
 struct EventQueue; // collection for demux'd for one event code
+struct EventCapture; // snapshot of all event codes around a trigger code
+struct GroupSnap; // snapshot of all group=yes queues of one EventLog
 struct EventDev; // operations
 
 epicsMutex eventLogsLock;
 std::map<std::string, std::unique_ptr<EventLog>> eventLogs;
 
+// lock, and count if first held by another thread
+struct CountingGuard {
+    epicsMutex& lock;
+    CountingGuard(epicsMutex& lock, std::atomic<uint32_t>& nWaits)
+        :lock(lock)
+    {
+        if(!lock.tryLock()) {
+            nWaits.fetch_add(1u, std::memory_order_relaxed);
+            lock.lock();
+        }
+    }
+    ~CountingGuard() { lock.unlock(); }
+};
+
 struct EventLog {
     const std::string name;
 
     epicsMutex lock;
     uint32_t nOverflows=0u;
-    double nsecPerTick = 1.0;
+    double nsecPerTick = 1.0; // applied to input
+    double nsecNominal = 1.0; // from Event Table Set Mult
+
+    /* Discipline nsecPerTick from the event stream.
+     * The tick counter resets on each second rollover.
+     *
+     * With discCode, that code is a periodic event phase locked to the
+     * tick clock.  A second where its intervals are uniform gives the
+     * period, and the first occurrence in the following second locates
+     * the rollover.  So ticks per second = last + period - first.
+     *
+     * Without, the largest tick seen during a second is a lower bound,
+     * which sparse events bias low.  It is only used when within discGap
+     * ticks of nominal.
+     *
+     * Take the median estimate from a window of recent seconds.
+     */
+    bool discipline = false;
+    size_t discWindow = 16u;
+    double discPPM = 1000.0; // ignore estimates further from nominal
+    uint8_t discCode = 0u; // periodic event code, or zero
+    epicsUInt32 discGap = 4u; // ticks.  without discCode
+    epicsUInt32 discSec = 0u; // current second
+    epicsUInt32 discMaxTick = 0u; // largest tick seen in discSec
+    epicsUInt32 discPeriod = 0u; // of discCode in discSec, or zero
+    bool discUniform = false; // discCode intervals in discSec agree
+    std::deque<epicsUInt32> discCounts; // estimates from completed seconds
+    std::vector<epicsUInt32> discSorted; // scratch for median
+    bool discChanged = false;
+    double ticksPerSec = 0.0; // estimate, or zero
+    ShardScan onDiscipline;
+    unsigned discChanging=0u; // onDiscipline scan priority mask in progress
+
+    ScanShard* const shard; // nullptr for callback queues
 
     std::map<std::string, std::unique_ptr<EventQueue>> queues;
     std::multimap<uint8_t, EventQueue*> listeners;
 
+    std::map<std::string, std::unique_ptr<EventCapture>> captures;
+    std::vector<EventCapture*> capturing; // captures with a trigger code set
+
+    // most recent events of all codes.  Sized for the largest EventCapture::nPre
+    std::vector<EventRec> history;
+    size_t historyNext=0u, historyCount=0u;
+
+    std::vector<EventLogObserver*> observers;
+    std::vector<EventRec> batch; // decoded input, when observers present
+
+    // Inputs with src= , merged in timestamp order
+    struct Source {
+        std::deque<EventRec> pending; // time ordered, not yet dispatched
+        bool seen = false;
+        epicsTimeStamp latest; // newest received
+    };
+    std::map<std::string, Source> sources;
+    uint64_t reorderWindow = 10000000u; // ns
+    bool merged = false; // any event dispatched through merge
+    epicsTimeStamp lastMerged; // newest dispatched through merge
+    epicsTimeStamp newest; // newest received from any source
+    uint32_t nLate=0u; // dropped, older than lastMerged
+    uint32_t nReordered=0u; // received older than newest
+    size_t nHeld=0u, maxHeld=0u; // sum of Source::pending sizes
+
+    uint64_t epoch=0u; // count of input batches
+    uint64_t nEvents=0u; // decoded from input
+
+    // SCAN=Event for codes selected by dbevent= .  [code] nullptr if not selected
+    EVENTPVT dbEvents[256] = {};
+    epicsUInt64 dbEventPosted[256] = {}; // epicsMonotonicGet() of last post
+    double dbEventMaxLat[256] = {}; // sec, from post to Event Table DB Event Latency
+    uint32_t nDbEvents=0u; // posted
+
+    // lock contention by Event Table Input, and by Event Table Buffer
+    std::atomic<uint32_t> nInputWaits{0u}, nReadWaits{0u};
+    // for ingest rate.  Only accessed by eventTableReport()
+    uint64_t reportEvents=0u;
+    epicsUInt64 reportTime=0u;
+
+    // group snapshot of queues with Event Table Buffer group=yes
+    std::vector<EventQueue*> grouped; // [EventQueue::groupIdx]
+    ShardScan onBatch;
+    unsigned batchChanging=0u; // onBatch scan priority mask in progress
+    bool batchChanged=false; // grouped queue appended during current batch
+    bool batchPending=false; // grouped queue appended during onBatch scan
+    // Replaced under lock just before each onBatch scan pass.  Read by
+    // records without lock, through std::atomic_load().  nullptr until first.
+    std::shared_ptr<GroupSnap> groupSnap;
+    // previous snapshots, possibly still referenced by records
+    std::vector<std::shared_ptr<GroupSnap>> snapSpare;
+
+    static
+    void onBatchComplete(void *usr, IOSCANPVT, int prio) noexcept;
+    static
+    void onDisciplineComplete(void *usr, IOSCANPVT, int prio) noexcept;
+
     explicit
         EventLog(const std::string& name)
         :name(name)
-    {}
+        ,shard(scanShardFor(name))
+    {
+        lastMerged.secPastEpoch = lastMerged.nsec = 0u;
+        newest = lastMerged;
+        shardScanInit(onBatch, shard, onBatchComplete, this);
+        shardScanInit(onDiscipline, shard, onDisciplineComplete, this);
+    }
+
+    static
+    EventLog* getCreate(const std::string& logName) {
+        Guard G(eventLogsLock);
+        auto& log(eventLogs[logName]);
+        if(!log) {
+            log.reset(new EventLog(logName));
+        }
+        return log.get();
+    }
+
+    // must lock
+    void capture(const EventRec& rec);
+    // must lock
+    void snapshot();
+    // must lock.  Replace snapshot, then scan group=yes records
+    void requestBatch() {
+        snapshot();
+        batchChanging = shardScanRequest(onBatch);
+    }
+    // must lock
+    size_t snapFootprint() const;
+    // must lock.  Deliver one event to queues, captures, and observers
+    void dispatch(const EventRec& rec);
+    // must lock.  Hold one event from a source
+    void hold(Source& src, const EventRec& rec);
+    // must lock.  Dispatch held events no longer subject to reordering
+    void merge();
+
+    // must lock
+    void observeTick(uint8_t code, epicsUInt32 sec, epicsUInt32 tick) {
+        if(discCode && code!=discCode)
+            return;
+
+        if(sec==discSec) {
+            if(discCode && discUniform) {
+                if(tick<=discMaxTick) {
+                    discUniform = false; // duplicate or out of order
+
+                } else if(!discPeriod) {
+                    discPeriod = tick - discMaxTick;
+
+                } else {
+                    epicsUInt32 dT = tick - discMaxTick;
+                    if(dT+1u < discPeriod || dT > discPeriod+1u)
+                        discUniform = false; // missed event, or not periodic
+                }
+            }
+            discMaxTick = std::max(discMaxTick, tick);
+            return;
+        }
+
+        if(sec==discSec+1u && discMaxTick) {
+            double nominal = 1e9/nsecNominal;
+            epicsUInt32 count = 0u;
+
+            if(!discCode) {
+                count = discMaxTick+1u;
+                if(fabs(count - nominal) > discGap)
+                    count = 0u; // events not dense enough near rollover
+
+            } else if(discUniform && discPeriod && tick<discPeriod) {
+                count = discMaxTick + discPeriod - tick;
+            }
+
+            if(count && fabs(count/nominal - 1.0)*1e6 <= discPPM) {
+                discCounts.push_back(count);
+                while(discCounts.size() > discWindow)
+                    discCounts.pop_front();
+                discChanged = true;
+            }
+        }
+        // else. gap or step.  start over
+
+        discSec = sec;
+        discMaxTick = tick;
+        discPeriod = 0u;
+        discUniform = true;
+    }
+
+    // must lock.  Apply estimate after each batch
+    void updateDiscipline() {
+        if(!discChanged)
+            return;
+        discChanged = false;
+
+        discSorted.assign(discCounts.begin(), discCounts.end());
+        auto mid = discSorted.begin() + discSorted.size()/2u;
+        std::nth_element(discSorted.begin(), mid, discSorted.end());
+        ticksPerSec = *mid;
+        if(discSorted.size()%2u==0u) {
+            // mean of the two middle
+            auto below = *std::max_element(discSorted.begin(), mid);
+            ticksPerSec = (ticksPerSec + below)/2.0;
+        }
+        nsecPerTick = 1e9/ticksPerSec;
+
+        if(!discChanging)
+            discChanging = shardScanRequest(onDiscipline);
+    }
+
+    // must lock
+    void resetDiscipline() {
+        discSec = discMaxTick = discPeriod = 0u;
+        discUniform = false;
+        discCounts.clear();
+        discChanged = false;
+        ticksPerSec = 0.0;
+        nsecPerTick = nsecNominal;
+        if(!discChanging)
+            discChanging = shardScanRequest(onDiscipline);
+    }
+};
+
+/* One column of queued events.  Filled during input, then swapped into
+ * records as aai BPTR so output needs no per-element conversion.
+ */
+template<typename T>
+struct Column {
+    typedef std::vector<T> vec_t;
+    std::shared_ptr<vec_t> fill, pub;
+    // previously published, possibly still referenced by records
+    std::vector<std::shared_ptr<vec_t>> spare;
+
+    void reserve(size_t n) {
+        if(!fill) {
+            fill = std::make_shared<vec_t>(n);
+        } else if(fill->size() < n) {
+            fill->resize(n);
+        }
+    }
+
+    void publish(size_t n) {
+        if(pub)
+            spare.push_back(std::move(pub));
+        pub = std::move(fill);
+        fill.reset();
+
+        for(auto it(spare.begin()), end(spare.end()); it!=end; ++it) {
+            if(it->use_count()==1) { // no longer referenced by any record
+                fill = std::move(*it);
+                spare.erase(it);
+                break;
+            }
+        }
+        reserve(n);
+    }
+
+    size_t footprint() const {
+        size_t bytes = 0u;
+        if(fill)
+            bytes += fill->capacity()*sizeof(T);
+        if(pub)
+            bytes += pub->capacity()*sizeof(T);
+        for(auto& vec : spare)
+            bytes += vec->capacity()*sizeof(T);
+        return bytes;
+    }
+};
+
+// Columns of one EventQueue::publish(), as read by records
+struct Published {
+    size_t n = 0u;
+    epicsTimeStamp first;
+    std::shared_ptr<Column<epicsInt64>::vec_t> colAbs;
+    std::shared_ptr<Column<epicsUInt32>::vec_t> colSec, colNsec;
 };
 
 struct EventQueue {
     EventLog* const log;
 
+    // for DOUBLE Event Table Buffer
+    bool listed = false;
     std::list<epicsTime> unused, que;
+
+    bool group = false; // member of EventLog::grouped
+    size_t groupIdx = 0u; // in EventLog::grouped
+
+    // overflow policy and decimation
+    bool dropOldest = false;
+    uint32_t every = 1u; // keep every Nth
+    uint32_t everyCount = 0u; // since last kept
+    uint32_t limit = 0u; // keep at most limit per period, 0 for no limit
+    uint64_t period = 1000000000u; // ns
+    uint32_t periodCount = 0u; // kept in current period
+    bool periodStarted = false;
+    epicsTimeStamp periodStart;
+    uint32_t nOverflows=0u, nDecimated=0u;
+
+    // for INT64 and ULONG Event Table Buffer
+    bool columnar = false;
+    bool needPublish = true; // next columnar read begins a new scan pass
+    size_t nCol=0u, nFill=0u;
+    size_t fillStart=0u; // oldest in fill, when full and dropOldest
+    epicsTimeStamp firstFill;
+    Published published;
+    Column<epicsInt64> colAbs; // ns since POSIX epoch
+    Column<epicsUInt32> colSec; // sec since POSIX epoch
+    Column<epicsUInt32> colNsec;
+    bool fillAbs=false, fillSec=false, fillNsec=false; // columns with a reader
+
     epicsTime last;
-    IOSCANPVT onChange;
+    ShardScan onChange;
 
     uint32_t nOccur=0u;
+    size_t maxFill=0u; // high-water mark of fill()
     uint32_t nLimit=0u;
     uint8_t event=0u;
     unsigned changing=0u; // onChange scan priority mask in progress, for rate limiting
 
+    // maxrate= throttling of onChange
+    double minInterval = 0.0; // sec, 0 for no limit
+    epicsUInt64 lastScan = 0u; // epicsMonotonicGet() of last onChange request
+    bool dirty = false; // wakeup coalesced since last request
+    bool flushPending = false; // flushTimer armed
+    ShardTimer flushTimer; // on the shard of the EventLog
+    uint32_t nSuppressed = 0u;
+
     static
     void onChangeComplete(void *usr, IOSCANPVT, int prio) noexcept;
+    static
+    void onFlush(void *usr) noexcept;
 
     explicit
     EventQueue(EventLog* log)
         :log(log)
     {
-        scanIoInit(&onChange);
-        scanIoSetComplete(onChange, onChangeComplete, this);
+        firstFill.secPastEpoch = firstFill.nsec = 0u;
+        published.first = firstFill;
+        shardScanInit(onChange, log->shard, onChangeComplete, this);
+        shardTimerInit(flushTimer, log->shard, onFlush, this);
+    }
+
+    // must lock.  Request onChange now, or delayed until minInterval after the last
+    void throttledRequest() {
+        auto now = epicsMonotonicGet();
+        double since = (now - lastScan)*1e-9;
+        if(since >= minInterval) {
+            lastScan = now;
+            dirty = false;
+            changing = shardScanRequest(onChange);
+        } else {
+            flushPending = true;
+            shardTimerRequest(flushTimer, minInterval - since);
+        }
+    }
+
+    // must lock.  On each wakeup
+    void requestScan() {
+        if(!minInterval) {
+            if(!changing)
+                changing = shardScanRequest(onChange);
+
+        } else if(changing || flushPending) {
+            // will be followed by another request
+            dirty = true;
+            nSuppressed++;
+
+        } else {
+            throttledRequest();
+            if(flushPending)
+                nSuppressed++;
+        }
+    }
+
+    // must lock.  Events queued for the next read
+    size_t fill() const {
+        return listed ? que.size() : nFill;
+    }
+    size_t capacity() const {
+        return listed ? que.size() + unused.size() : nCol;
+    }
+    // must lock.  Approximate heap usage in bytes
+    size_t footprint() const {
+        // list node of value and two pointers
+        const size_t node = sizeof(epicsTime) + 2u*sizeof(void*);
+        return sizeof(*this)
+                + (que.size() + unused.size())*node
+                + colAbs.footprint() + colSec.footprint() + colNsec.footprint();
+    }
+
+    // must lock.  Apply decimation.  Returns true if event should be queued
+    bool keep(const epicsTimeStamp& ts) {
+        if(every>1u) {
+            if(++everyCount < every) {
+                nDecimated++;
+                return false;
+            }
+            everyCount = 0u;
+        }
+        if(limit) {
+            if(!periodStarted || diffNS(ts, periodStart) >= int64_t(period)) {
+                periodStarted = true;
+                periodStart = ts;
+                periodCount = 0u;
+            }
+            if(periodCount >= limit) {
+                nDecimated++;
+                return false;
+            }
+            periodCount++;
+        }
+        return true;
+    }
+
+    // must lock
+    void overflow() {
+        nOverflows++;
+        log->nOverflows++;
+    }
+
+    // must lock.  Returns false on overflow.  Caller counts overflow()
+    bool push(const epicsTimeStamp& ts) {
+        size_t idx = nFill;
+        bool wrap = nFill >= nCol;
+        if(wrap) {
+            if(!dropOldest || !nCol)
+                return false;
+            // overwrite oldest.  Rotated into order on publish
+            idx = fillStart;
+            fillStart = (fillStart+1u) % nCol;
+        } else {
+            if(!nFill)
+                firstFill = ts;
+            nFill++;
+        }
+        epicsUInt32 sec = ts.secPastEpoch + POSIX_TIME_AT_EPICS_EPOCH;
+        if(fillAbs)
+            (*colAbs.fill)[idx] = epicsInt64(sec)*1000000000 + ts.nsec;
+        if(fillSec)
+            (*colSec.fill)[idx] = sec;
+        if(fillNsec)
+            (*colNsec.fill)[idx] = ts.nsec;
+        if(wrap) {
+            // after the write, which may be the new oldest when nCol==1.
+            // With dropOldest, either fillAbs or both fillSec and fillNsec
+            if(fillAbs) {
+                auto abs = (*colAbs.fill)[fillStart];
+                firstFill.secPastEpoch = epicsUInt32(abs/1000000000) - POSIX_TIME_AT_EPICS_EPOCH;
+                firstFill.nsec = epicsUInt32(abs%1000000000);
+            } else {
+                firstFill.secPastEpoch = (*colSec.fill)[fillStart] - POSIX_TIME_AT_EPICS_EPOCH;
+                firstFill.nsec = (*colNsec.fill)[fillStart];
+            }
+        }
+        return !wrap;
+    }
+
+    // must lock
+    void publish() {
+        needPublish = false;
+        if(fillStart) {
+            if(fillAbs)
+                std::rotate(colAbs.fill->begin(), colAbs.fill->begin()+fillStart, colAbs.fill->begin()+nFill);
+            if(fillSec)
+                std::rotate(colSec.fill->begin(), colSec.fill->begin()+fillStart, colSec.fill->begin()+nFill);
+            if(fillNsec)
+                std::rotate(colNsec.fill->begin(), colNsec.fill->begin()+fillStart, colNsec.fill->begin()+nFill);
+            fillStart = 0u;
+        }
+        published = Published(); // release, so the previous may be reused
+        if(fillAbs)
+            colAbs.publish(nCol);
+        if(fillSec)
+            colSec.publish(nCol);
+        if(fillNsec)
+            colNsec.publish(nCol);
+        published.n = nFill;
+        published.first = firstFill;
+        published.colAbs = colAbs.pub;
+        published.colSec = colSec.pub;
+        published.colNsec = colNsec.pub;
+        nFill = 0u;
     }
 
     static
         EventQueue* getCreate(const std::string& logName,
                               const std::string& queueName) {
+        auto log(EventLog::getCreate(logName));
         Guard G(eventLogsLock);
-        auto& log(eventLogs[logName]);
-        if(!log) {
-            log.reset(new EventLog(logName));
-        }
         auto& queue(log->queues[queueName]);
         if(!queue) {
-            queue.reset(new EventQueue(log.get()));
+            queue.reset(new EventQueue(log));
         }
         return queue.get();
     }
 };
 
+/* Immutable once published by EventLog::snapshot() */
+struct GroupSnap {
+    uint64_t epoch = 0u;
+
+    struct Queue {
+        std::list<epicsTime> times; // DOUBLE
+        Published published; // INT64 and ULONG
+    };
+    std::vector<Queue> queues; // [EventQueue::groupIdx]
+};
+
+void EventLog::snapshot()
+{
+    std::shared_ptr<GroupSnap> next;
+    for(auto it(snapSpare.begin()), end(snapSpare.end()); it!=end; ++it) {
+        if(it->use_count()==1) { // no longer referenced by any record
+            next = std::move(*it);
+            snapSpare.erase(it);
+            break;
+        }
+    }
+    if(!next)
+        next = std::make_shared<GroupSnap>();
+
+    next->epoch = epoch;
+    next->queues.resize(grouped.size());
+
+    for(size_t i=0u; i<grouped.size(); i++) {
+        auto que = grouped[i];
+        auto& snap = next->queues[i];
+
+        if(que->listed) {
+            que->unused.splice(que->unused.end(), snap.times);
+            snap.times.splice(snap.times.end(), que->que);
+        }
+        if(que->columnar) {
+            snap.published = Published(); // release, so columns may be reused
+            que->publish();
+            snap.published = que->published;
+        }
+    }
+
+    if(groupSnap)
+        snapSpare.push_back(groupSnap);
+    std::atomic_store(&groupSnap, next);
+}
+
+size_t EventLog::snapFootprint() const
+{
+    // list node of value and two pointers
+    const size_t node = sizeof(epicsTime) + 2u*sizeof(void*);
+    size_t bytes = 0u;
+    auto count = [&bytes, node](const GroupSnap& snap) {
+        bytes += sizeof(snap);
+        for(auto& que : snap.queues)
+            bytes += sizeof(que) + que.times.size()*node;
+    };
+    if(groupSnap)
+        count(*groupSnap);
+    for(auto& snap : snapSpare)
+        count(*snap);
+    return bytes;
+}
+
+struct Capture {
+    epicsTimeStamp trigger; // time of trigger event
+    std::vector<EventRec> events; // pre-trigger, trigger, post-trigger
+};
+
+struct EventCapture {
+    EventLog* const log;
+    ShardScan onChange;
+
+    uint8_t trigger=0u;
+    size_t nPre=0u, nPost=0u, nKeep=1u;
+
+    // in progress
+    std::shared_ptr<Capture> pending;
+    size_t remaining=0u;
+
+    // completed, newest first, at most nKeep
+    std::deque<std::shared_ptr<const Capture>> done;
+    // as seen by records.  Only updated while !changing
+    std::deque<std::shared_ptr<const Capture>> published;
+
+    uint32_t nCaptures=0u;
+    unsigned changing=0u;
+
+    static
+    void onChangeComplete(void *usr, IOSCANPVT, int prio) noexcept;
+
+    explicit
+    EventCapture(EventLog* log)
+        :log(log)
+    {
+        shardScanInit(onChange, log->shard, onChangeComplete, this);
+    }
+
+    // must lock
+    void start(const EventRec& rec) {
+        pending = std::make_shared<Capture>();
+        pending->trigger = rec.ts;
+        pending->events.reserve(nPre + 1u + nPost);
+
+        auto& hist = log->history;
+        size_t npre = std::min(nPre, log->historyCount);
+        for(size_t i=npre; i; i--) {
+            size_t idx = (log->historyNext + hist.size() - i) % hist.size();
+            pending->events.push_back(hist[idx]);
+        }
+        pending->events.push_back(rec);
+
+        remaining = nPost;
+        if(!remaining)
+            complete();
+    }
+    // must lock
+    void complete() {
+        done.emplace_front(std::move(pending));
+        pending.reset();
+        while(done.size() > nKeep)
+            done.pop_back();
+        nCaptures++;
+
+        if(!changing) {
+            published = done;
+            changing = shardScanRequest(onChange);
+        }
+    }
+
+    static
+        EventCapture* getCreate(const std::string& logName,
+                                const std::string& captureName) {
+        auto log(EventLog::getCreate(logName));
+        Guard G(eventLogsLock);
+        auto& capture(log->captures[captureName]);
+        if(!capture) {
+            capture.reset(new EventCapture(log));
+        }
+        return capture.get();
+    }
+};
+
+void EventLog::capture(const EventRec& rec)
+{
+    for(auto cap : capturing) {
+        if(cap->pending) {
+            cap->pending->events.push_back(rec);
+            if(!--cap->remaining)
+                cap->complete();
+
+        } else if(rec.code==cap->trigger) {
+            cap->start(rec);
+        }
+    }
+
+    if(!history.empty()) {
+        history[historyNext] = rec;
+        historyNext = (historyNext+1u) % history.size();
+        if(historyCount < history.size())
+            historyCount++;
+    }
+}
+
+void EventLog::dispatch(const EventRec& rec)
+{
+    auto it(listeners.lower_bound(rec.code));
+    auto end(listeners.upper_bound(rec.code));
+    for(; it!=end; ++it) {
+        auto que = it->second;
+        que->last = rec.ts;
+        que->nOccur++;
+
+        if(!que->keep(rec.ts)) {
+            // decimated
+
+        } else if(!que->listed) {
+            // no DOUBLE buffer
+            if(que->columnar && !que->push(rec.ts))
+                que->overflow();
+
+        } else {
+            bool full = false;
+
+            if(!que->unused.empty()) {
+                // move first unused to end of queue
+                auto it = que->unused.begin();
+                *it = rec.ts;
+                que->que.splice(que->que.end(),
+                                que->unused,
+                                it);
+
+            } else if(que->dropOldest && !que->que.empty()) {
+                // recycle oldest to end of queue
+                full = true;
+                auto it = que->que.begin();
+                *it = rec.ts;
+                que->que.splice(que->que.end(),
+                                que->que,
+                                it);
+
+            } else {
+                full = true;
+            }
+
+            if(que->columnar && !que->push(rec.ts))
+                full = true;
+
+            // once per event, when both DOUBLE and columnar buffers are full
+            if(full)
+                que->overflow();
+        }
+
+        que->maxFill = std::max(que->maxFill, que->fill());
+        if(que->group)
+            batchChanged = true;
+        que->requestScan();
+    }
+
+    if(auto evt = dbEvents[rec.code]) {
+        dbEventPosted[rec.code] = epicsMonotonicGet();
+        postEvent(evt);
+        nDbEvents++;
+    }
+
+    if(!capturing.empty())
+        capture(rec);
+
+    if(!observers.empty())
+        batch.push_back(rec);
+}
+
+void EventLog::hold(Source& src, const EventRec& rec)
+{
+    if(merged && diffNS(rec.ts, lastMerged) < 0) {
+        nLate++; // already dispatched past
+        return;
+    }
+
+    if(!src.seen || diffNS(rec.ts, src.latest) >= 0) {
+        src.pending.push_back(rec);
+        src.latest = rec.ts;
+    } else {
+        // out of order within one source.  Unusual
+        auto pos = std::upper_bound(src.pending.begin(), src.pending.end(), rec,
+                                    [](const EventRec& a, const EventRec& b) {
+            return diffNS(a.ts, b.ts) < 0;
+        });
+        src.pending.insert(pos, rec);
+    }
+
+    if(diffNS(rec.ts, newest) < 0) {
+        if(nHeld)
+            nReordered++; // will be dispatched before some already held
+    } else {
+        newest = rec.ts;
+    }
+    src.seen = true;
+
+    nHeld++;
+    maxHeld = std::max(maxHeld, nHeld);
+}
+
+void EventLog::merge()
+{
+    /* k-way merge.  Few sources, so linear search for the oldest head.
+     * The oldest is dispatched once every other source has received an
+     * event at least as new, or it has aged out of the reorder window.
+     */
+    while(nHeld) {
+        Source* next = nullptr;
+        for(auto& pair : sources) {
+            auto& src = pair.second;
+            if(!src.pending.empty() && (!next || diffNS(src.pending.front().ts,
+                                                        next->pending.front().ts) < 0))
+                next = &src;
+        }
+        assert(next);
+        auto& rec = next->pending.front();
+
+        bool ready = diffNS(newest, rec.ts) >= int64_t(reorderWindow);
+        if(!ready) {
+            ready = true;
+            for(auto& pair : sources) {
+                auto& src = pair.second;
+                if(&src!=next && (!src.seen || diffNS(src.latest, rec.ts) < 0)) {
+                    ready = false;
+                    break;
+                }
+            }
+        }
+        if(!ready)
+            break;
+
+        lastMerged = rec.ts;
+        merged = true;
+        dispatch(rec);
+        next->pending.pop_front();
+        nHeld--;
+    }
+}
+
+long eventTableReport(int lvl) noexcept
+{
+    try {
+        // copied under lock, printed after
+        struct QueueInfo {
+            const std::string* name;
+            uint8_t code;
+            size_t fill, capacity, maxFill, bytes;
+            uint32_t nOccur, nOverflows;
+            epicsTime last;
+        };
+        std::vector<QueueInfo> infos;
+        std::vector<uint16_t> nListeners(256u);
+
+        Guard T(eventLogsLock);
+
+        for(auto& pair : eventLogs) {
+            auto& log = *pair.second;
+
+            size_t nQueues = log.queues.size(), nObservers, nHeld, bytes;
+            uint64_t nEvents, epoch;
+            uint32_t nOverflows, nDbEvents;
+            std::vector<bool> dbEvents(256u);
+            infos.clear();
+            std::fill(nListeners.begin(), nListeners.end(), 0u);
+            {
+                Guard G(log.lock);
+
+                nObservers = log.observers.size();
+                nHeld = log.nHeld;
+                nEvents = log.nEvents;
+                epoch = log.epoch;
+                nOverflows = log.nOverflows;
+                nDbEvents = log.nDbEvents;
+                for(size_t code=0u; code<dbEvents.size(); code++)
+                    dbEvents[code] = log.dbEvents[code];
+                bytes = sizeof(log)
+                        + (log.history.capacity() + log.batch.capacity() + nHeld)*sizeof(EventRec)
+                        + log.snapFootprint();
+
+                for(auto& qpair : log.queues) {
+                    auto& que = *qpair.second;
+                    bytes += que.footprint();
+                    if(lvl>=1)
+                        infos.push_back(QueueInfo{&qpair.first, que.event,
+                                                  que.fill(), que.capacity(), que.maxFill, que.footprint(),
+                                                  que.nOccur, que.nOverflows, que.last});
+                }
+                for(auto& lpair : log.listeners)
+                    nListeners[lpair.first]++;
+            }
+
+            printf("  \"%s\" : %zu queues, %zu observers, %llu events, %u overflows, %zu held, %zu bytes\n",
+                   pair.first.c_str(), nQueues, nObservers, (unsigned long long)nEvents,
+                   unsigned(nOverflows), nHeld, bytes);
+
+            if(lvl>=2) {
+                auto now = epicsMonotonicGet();
+                auto inputWaits = log.nInputWaits.load(std::memory_order_relaxed);
+                auto readWaits = log.nReadWaits.load(std::memory_order_relaxed);
+
+                printf("    lock waits: input %u of %llu batches, buffer read %u\n",
+                       unsigned(inputWaits), (unsigned long long)epoch, unsigned(readWaits));
+                if(log.reportTime) {
+                    double dT = (now - log.reportTime)*1e-9;
+                    printf("    ingest: %.1f events/sec over %.1f sec since last report\n",
+                           dT>0.0 ? (nEvents - log.reportEvents)/dT : 0.0, dT);
+                } else {
+                    printf("    ingest: rate from next report\n");
+                }
+                log.reportEvents = nEvents;
+                log.reportTime = now;
+            }
+
+            if(lvl<=0)
+                continue;
+
+            printf("    EVT# = listening queues\n");
+            for(unsigned code=0u; code<nListeners.size(); code++) {
+                if(nListeners[code])
+                    printf("    %3u - %u\n", code, unsigned(nListeners[code]));
+            }
+            if(std::find(dbEvents.begin(), dbEvents.end(), true)!=dbEvents.end()) {
+                printf("    DB events posted %u, for EVT#", unsigned(nDbEvents));
+                for(unsigned code=0u; code<dbEvents.size(); code++) {
+                    if(dbEvents[code])
+                        printf(" %u", code);
+                }
+                printf("\n");
+            }
+
+            for(auto& info : infos) {
+                char last[40] = "never";
+                if(info.nOccur)
+                    (void)info.last.strftime(last, sizeof(last), "%Y-%m-%d %H:%M:%S.%09f");
+
+                printf("    \"%s\" EVT %u : fill %zu/%zu, hwm %zu, nOccur %u, overflows %u, %zu bytes, last %s\n",
+                       info.name->c_str(), info.code, info.fill, info.capacity, info.maxFill,
+                       unsigned(info.nOccur), unsigned(info.nOverflows), info.bytes, last);
+            }
+        }
+
+        return 0;
+    } catch(std::exception& e) {
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", __func__, e.what());
+        return -1;
+    }
+}
+
+drvet drvEventTable = {
+    2, eventTableReport, NULL,
+};
+
 struct EventDev {
     dbCommon* const prec;
     EventQueue* const queue;
+    EventCapture* capture = nullptr;
+    EventLog::Source* source = nullptr; // Event Table Input with src=
     bool autoclear = false;
+    bool group = false;
+
+    enum col_t {
+        Code, Sec, Nsec,
+    } col = Code;
+    size_t idx = 0u;
+
+    // Event Table Freq
+    enum stat_t {
+        Freq, // measured ticks/sec (MHz)
+        Corr, // measured relative to nominal (ppm)
+        // Event Table Merge Stat
+        Late, Reordered, Held, MaxHeld, Events,
+        // Event Table Queue Stat
+        Overflows, Decimated, Suppressed, Occur, MaxFill,
+        // Event Table DB Event Latency
+        LatLast, LatMax,
+    } stat = Freq;
+    uint8_t code = 0u; // Event Table DB Event Latency
+
+    // Event Table Buffer output format, from FTVL and col=
+    enum fmt_t {
+        Rel,  // DOUBLE seconds relative to first
+        Abs,  // INT64 ns since POSIX epoch
+        ASec, // ULONG sec since POSIX epoch
+        ANsec,// ULONG ns
+    } fmt = Rel;
+    // published Column buffer currently in BPTR
+    std::shared_ptr<void> ref;
+    void *ownBptr = nullptr; // allocated by aaiRecord, in BPTR when no ref
 
     constexpr
     EventDev(dbCommon *prec, EventQueue* queue)
@@ -131,57 +1070,255 @@ struct EventDev {
     {}
 };
 
-long eventLogInitRecord(dbCommon *prec) noexcept {
-    try {
-        auto plink(dbGetDevLink(prec));
-        assert(plink->type==INST_IO);
-        std::string lstr(plink->value.instio.string);
+struct EventLink {
+    std::string logName, queueName, captureName, sourceName;
+    std::string dbEvents; // comma separated codes, or "all"
+    int code = 0;
+    uint64_t reorder = 0u; // ns, 0 for default
+    bool dropOldest = false;
+    uint32_t every = 1u, limit = 0u;
+    uint64_t period = 0u; // ns, 0 for default
+    double maxrate = 0.0; // Hz, 0 for no limit
+    bool autoclear = true;
+    bool group = false;
+    size_t pre = 0u, post = 0u, keep = 1u;
+    EventDev::col_t col = EventDev::Code;
+    size_t idx = 0u;
+    size_t window = 16u;
+    double ppm = 1000.0;
+    uint32_t gap = 4u; // ticks
+    EventDev::stat_t stat = EventDev::Freq;
+
+    explicit EventLink(dbCommon *prec);
+};
+
+EventLink::EventLink(dbCommon *prec)
+{
+    auto plink(dbGetDevLink(prec));
+    assert(plink->type==INST_IO);
+    std::string lstr(plink->value.instio.string);
+
+    char *saved = nullptr;
+    for(char* word = epicsStrtok_r((char*)lstr.data(), " ", &saved)
+         ; word
+         ; word = epicsStrtok_r(NULL, " ", &saved))
+    {
+        auto wlen = strlen(word);
 
+        auto cmd = [=](const char *pref) -> const char* {
+            auto plen = strlen(pref);
+            if(wlen >= plen && memcmp(word, pref, plen)==0) {
+                return word + plen;
+            }
+            return nullptr;
+        };
 
-        std::string logName, queueName;
-        bool autoclear = true;
+        if(auto val = cmd("log=")) {
+            logName = val;
 
-        char *saved = nullptr;
-        for(char* word = epicsStrtok_r((char*)lstr.data(), " ", &saved)
-             ; word
-             ; word = epicsStrtok_r(NULL, " ", &saved))
-        {
-            auto wlen = strlen(word);
+        } else if(auto val = cmd("queue=")) {
+            queueName = val;
 
-            auto cmd = [=](const char *pref) -> const char* {
-                auto plen = strlen(pref);
-                if(wlen >= plen && memcmp(word, pref, plen)==0) {
-                    return word + plen;
-                }
-                return nullptr;
-            };
+        } else if(auto val = cmd("src=")) {
+            sourceName = val;
 
-            if(auto val = cmd("log=")) {
-                logName = val;
+        } else if(auto val = cmd("dbevent=")) {
+            dbEvents = val;
 
-            } else if(auto val = cmd("queue=")) {
-                queueName = val;
+        } else if(auto val = cmd("code=")) {
+            code = std::stoi(val, nullptr, 0);
+            if(code<1 || code>255)
+                throw std::runtime_error("code= must be 1-255");
 
-            } else if(auto val = cmd("autoclear=")) {
-                if(epicsStrCaseCmp(val, "yes")==0) {
-                    autoclear = true;
-                } else if(epicsStrCaseCmp(val, "no")==0) {
-                    autoclear = true;
-                } else {
-                    throw std::runtime_error("autoclear= must be 'yes' or 'no'");
-                }
+        } else if(auto val = cmd("overflow=")) {
+            if(epicsStrCaseCmp(val, "newest")==0) {
+                dropOldest = false;
+            } else if(epicsStrCaseCmp(val, "oldest")==0) {
+                dropOldest = true;
+            } else {
+                throw std::runtime_error("overflow= must be 'newest' or 'oldest'");
+            }
+
+        } else if(auto val = cmd("every=")) {
+            every = std::stoul(val, nullptr, 0);
+            if(!every)
+                throw std::runtime_error("every= must be >0");
+
+        } else if(auto val = cmd("limit=")) {
+            limit = std::stoul(val, nullptr, 0);
+
+        } else if(auto val = cmd("period=")) {
+            period = std::stoull(val, nullptr, 0);
+            if(!period)
+                throw std::runtime_error("period= must be >0");
+
+        } else if(auto val = cmd("maxrate=")) {
+            maxrate = std::stod(val);
+            if(!(maxrate>0.0) || !isfinite(maxrate))
+                throw std::runtime_error("maxrate= must be >0");
+
+        } else if(auto val = cmd("reorder=")) {
+            reorder = std::stoull(val, nullptr, 0);
+            if(!reorder)
+                throw std::runtime_error("reorder= must be >0");
+
+        } else if(auto val = cmd("autoclear=")) {
+            if(epicsStrCaseCmp(val, "yes")==0) {
+                autoclear = true;
+            } else if(epicsStrCaseCmp(val, "no")==0) {
+                autoclear = false;
+            } else {
+                throw std::runtime_error("autoclear= must be 'yes' or 'no'");
+            }
+
+        } else if(auto val = cmd("group=")) {
+            if(epicsStrCaseCmp(val, "yes")==0) {
+                group = true;
+            } else if(epicsStrCaseCmp(val, "no")==0) {
+                group = false;
+            } else {
+                throw std::runtime_error("group= must be 'yes' or 'no'");
+            }
+
+        } else if(auto val = cmd("capture=")) {
+            captureName = val;
+
+        } else if(auto val = cmd("pre=")) {
+            pre = std::stoul(val, nullptr, 0);
+
+        } else if(auto val = cmd("post=")) {
+            post = std::stoul(val, nullptr, 0);
+
+        } else if(auto val = cmd("keep=")) {
+            keep = std::stoul(val, nullptr, 0);
+            if(!keep)
+                throw std::runtime_error("keep= must be >0");
+
+        } else if(auto val = cmd("col=")) {
+            if(epicsStrCaseCmp(val, "code")==0) {
+                col = EventDev::Code;
+            } else if(epicsStrCaseCmp(val, "sec")==0) {
+                col = EventDev::Sec;
+            } else if(epicsStrCaseCmp(val, "ns")==0) {
+                col = EventDev::Nsec;
+            } else {
+                throw std::runtime_error("col= must be 'code', 'sec', or 'ns'");
+            }
 
+        } else if(auto val = cmd("idx=")) {
+            idx = std::stoul(val, nullptr, 0);
+
+        } else if(auto val = cmd("window=")) {
+            window = std::stoul(val, nullptr, 0);
+            if(!window)
+                throw std::runtime_error("window= must be >0");
+
+        } else if(auto val = cmd("ppm=")) {
+            ppm = std::stod(val);
+
+        } else if(auto val = cmd("gap=")) {
+            gap = std::stoul(val, nullptr, 0);
+
+        } else if(auto val = cmd("stat=")) {
+            if(epicsStrCaseCmp(val, "freq")==0) {
+                stat = EventDev::Freq;
+            } else if(epicsStrCaseCmp(val, "corr")==0) {
+                stat = EventDev::Corr;
+            } else if(epicsStrCaseCmp(val, "late")==0) {
+                stat = EventDev::Late;
+            } else if(epicsStrCaseCmp(val, "reordered")==0) {
+                stat = EventDev::Reordered;
+            } else if(epicsStrCaseCmp(val, "held")==0) {
+                stat = EventDev::Held;
+            } else if(epicsStrCaseCmp(val, "maxheld")==0) {
+                stat = EventDev::MaxHeld;
+            } else if(epicsStrCaseCmp(val, "events")==0) {
+                stat = EventDev::Events;
+            } else if(epicsStrCaseCmp(val, "overflows")==0) {
+                stat = EventDev::Overflows;
+            } else if(epicsStrCaseCmp(val, "decimated")==0) {
+                stat = EventDev::Decimated;
+            } else if(epicsStrCaseCmp(val, "suppressed")==0) {
+                stat = EventDev::Suppressed;
+            } else if(epicsStrCaseCmp(val, "occur")==0) {
+                stat = EventDev::Occur;
+            } else if(epicsStrCaseCmp(val, "maxfill")==0) {
+                stat = EventDev::MaxFill;
+            } else if(epicsStrCaseCmp(val, "last")==0) {
+                stat = EventDev::LatLast;
+            } else if(epicsStrCaseCmp(val, "max")==0) {
+                stat = EventDev::LatMax;
             } else {
-                throw std::runtime_error("Unexpected dev. link parameter");
+                throw std::runtime_error("stat= must be 'freq', 'corr', 'late', 'reordered', 'held', 'maxHeld', 'events',"
+                                         " 'overflows', 'decimated', 'suppressed', 'occur', 'maxFill', 'last', or 'max'");
             }
+
+        } else {
+            throw std::runtime_error("Unexpected dev. link parameter");
         }
+    }
+
+    if(logName.empty())
+        throw std::runtime_error("Missing log=");
+}
 
-        if(logName.empty())
-            throw std::runtime_error("Missing log=");
+long eventLogInitRecord(dbCommon *prec) noexcept {
+    try {
+        EventLink lnk(prec);
 
-        auto log(EventQueue::getCreate(logName, queueName));
+        auto log(EventQueue::getCreate(lnk.logName, lnk.queueName));
         auto pvt = new EventDev(prec, log);
-        pvt->autoclear = autoclear;
+        pvt->autoclear = lnk.autoclear;
+        pvt->group = lnk.group;
+        pvt->col = lnk.col;
+        pvt->stat = lnk.stat;
+        pvt->code = lnk.code;
+
+        if(!lnk.dbEvents.empty()) {
+            // lookup by name only during init
+            std::vector<EVENTPVT> handles(256u);
+            if(epicsStrCaseCmp(lnk.dbEvents.c_str(), "all")==0) {
+                for(int code=1; code<256; code++)
+                    handles[code] = eventNameToHandle(std::to_string(code).c_str());
+            } else {
+                size_t pos = 0u;
+                while(pos < lnk.dbEvents.size()) {
+                    auto sep = lnk.dbEvents.find(',', pos);
+                    if(sep==std::string::npos)
+                        sep = lnk.dbEvents.size();
+                    auto code = std::stoi(lnk.dbEvents.substr(pos, sep-pos), nullptr, 0);
+                    if(code<1 || code>255)
+                        throw std::runtime_error("dbevent= must be 'all', or event codes 1-255");
+                    handles[code] = eventNameToHandle(std::to_string(code).c_str());
+                    pos = sep+1u;
+                }
+            }
+
+            auto log = pvt->queue->log;
+            Guard G(log->lock);
+            for(size_t code=1u; code<handles.size(); code++) {
+                if(handles[code])
+                    log->dbEvents[code] = handles[code];
+            }
+        }
+
+        if(lnk.maxrate) {
+            if(lnk.group)
+                throw std::runtime_error("maxrate= not applicable with group=yes");
+            auto queue = pvt->queue;
+            Guard G(queue->log->lock);
+            // lowest maxrate= of any record of this queue
+            queue->minInterval = std::max(queue->minInterval, 1.0/lnk.maxrate);
+        }
+
+        if(!lnk.sourceName.empty() || lnk.reorder) {
+            auto log = pvt->queue->log;
+            Guard G(log->lock);
+            if(!lnk.sourceName.empty())
+                pvt->source = &log->sources[lnk.sourceName];
+            if(lnk.reorder)
+                log->reorderWindow = lnk.reorder;
+        }
         prec->dpvt = (void*)pvt;
 
         return 0;
@@ -198,7 +1335,29 @@ long eventTableChanged(int detach, struct dbCommon *prec, IOSCANPVT* pscan) noex
     if(!pvt)
         return -1;
 
-    *pscan = pvt->queue->onChange;
+    *pscan = pvt->group ? pvt->queue->log->onBatch.scan : pvt->queue->onChange.scan;
+    return 0;
+}
+
+long eventTableDiscipline(int detach, struct dbCommon *prec, IOSCANPVT* pscan) noexcept
+{
+    (void)detach;
+    auto pvt = static_cast<EventDev*>(prec->dpvt);
+    if(!pvt)
+        return -1;
+
+    *pscan = pvt->queue->log->onDiscipline.scan;
+    return 0;
+}
+
+long eventTableBatch(int detach, struct dbCommon *prec, IOSCANPVT* pscan) noexcept
+{
+    (void)detach;
+    auto pvt = static_cast<EventDev*>(prec->dpvt);
+    if(!pvt)
+        return -1;
+
+    *pscan = pvt->queue->log->onBatch.scan;
     return 0;
 }
 
@@ -234,7 +1393,7 @@ long eventLogInput(aaoRecord *prec) noexcept {
 
 
         {
-            Guard G(log->lock);
+            CountingGuard G(log->lock, log->nInputWaits);
 
             for(size_t n=0; n+2<N; n+=3) {
                 auto evtst = val[n+0];
@@ -245,49 +1404,136 @@ long eventLogInput(aaoRecord *prec) noexcept {
                 if(evtst&0x40000000) { // device side overflow before this event
                     log->nOverflows++;
                 }
+                log->nEvents++;
+
+                if(log->discipline)
+                    log->observeTick(evt, val[n+1], val[n+2]);
+
+                epicsTimeStamp ts;
+                ts.secPastEpoch = val[n+1] - POSIX_TIME_AT_EPICS_EPOCH; // (sec)
+                ts.nsec = val[n+2]*log->nsecPerTick + 0.5; // (ns)
+
+                if(pvt->source)
+                    log->hold(*pvt->source, EventRec{ts, uint8_t(evt)});
+                else
+                    log->dispatch(EventRec{ts, uint8_t(evt)});
+            }
+
+            if(pvt->source)
+                log->merge();
+
+            for(auto obs : log->observers) {
+                obs->onEvents(log->batch.data(), log->batch.size());
+            }
+            log->batch.clear(); // keeps capacity
+
+            // new scale applies to next batch
+            if(log->discipline)
+                log->updateDiscipline();
+
+            log->epoch++;
+            if(log->batchChanged) {
+                log->batchChanged = false;
+                if(!log->batchChanging) {
+                    log->requestBatch();
+                } else {
+                    log->batchPending = true;
+                }
+            }
+        };
+
+        return 0;
+    }CATCH
+}
+
+void EventQueue::onChangeComplete(void *usr, IOSCANPVT, int prio) noexcept
+{
+    auto self=static_cast<EventQueue*>(usr);
+    try {
+        unsigned mask = 1u<<prio;
+        Guard G(self->log->lock);
+        assert(self->changing & mask);
+        self->changing &= ~mask;
+        self->needPublish = true;
+
+        if(!self->changing && self->dirty && !self->flushPending) {
+            // trailing edge
+            self->throttledRequest();
+        }
+
+    }catch(std::exception& e){
+        errlogPrintf("%s: " ERL_ERROR ": %s\n", __func__, e.what());
+    }
+}
+
+void EventQueue::onFlush(void *usr) noexcept
+{
+    auto self=static_cast<EventQueue*>(usr);
+    try {
+        Guard G(self->log->lock);
+        self->flushPending = false;
+
+        if(self->changing) {
+            // onChangeComplete() will request again
+            self->dirty = true;
+        } else {
+            self->throttledRequest();
+        }
+
+    }catch(std::exception& e){
+        errlogPrintf("%s: " ERL_ERROR ": %s\n", __func__, e.what());
+    }
+}
+
+void EventLog::onBatchComplete(void *usr, IOSCANPVT, int prio) noexcept
+{
+    auto self=static_cast<EventLog*>(usr);
+    try {
+        unsigned mask = 1u<<prio;
+        Guard G(self->lock);
+        assert(self->batchChanging & mask);
+        self->batchChanging &= ~mask;
+
+        if(!self->batchChanging && self->batchPending) {
+            // appended while scanning
+            self->batchPending = false;
+            self->requestBatch();
+        }
 
-                epicsTimeStamp ts;
-                ts.secPastEpoch = val[n+1] - POSIX_TIME_AT_EPICS_EPOCH; // (sec)
-                ts.nsec = val[n+2]*log->nsecPerTick + 0.5; // (ns)
+    }catch(std::exception& e){
+        errlogPrintf("%s: " ERL_ERROR ": %s\n", __func__, e.what());
+    }
+}
 
-                auto it(log->listeners.lower_bound(evt));
-                auto end(log->listeners.upper_bound(evt));
-                for(; it!=end; ++it) {
-                    auto que = it->second;
-                    que->last = ts;
-                    que->nOccur++;
-
-                    if(que->unused.empty()) {
-                        log->nOverflows++;
-
-                    } else {
-                        auto it = que->unused.begin();
-                        *it = ts;
-
-                        // move first unused to end of queue
-                        que->que.splice(que->que.end(),
-                                        que->unused,
-                                        it);
-                    }
-                    if(!que->changing)
-                        que->changing = scanIoRequest(que->onChange);
-                }
-            }
-        };
+void EventLog::onDisciplineComplete(void *usr, IOSCANPVT, int prio) noexcept
+{
+    auto self=static_cast<EventLog*>(usr);
+    try {
+        unsigned mask = 1u<<prio;
+        Guard G(self->lock);
+        assert(self->discChanging & mask);
+        self->discChanging &= ~mask;
 
-        return 0;
-    }CATCH
+    }catch(std::exception& e){
+        errlogPrintf("%s: " ERL_ERROR ": %s\n", __func__, e.what());
+    }
 }
 
-void EventQueue::onChangeComplete(void *usr, IOSCANPVT, int prio) noexcept
+void EventCapture::onChangeComplete(void *usr, IOSCANPVT, int prio) noexcept
 {
-    auto self=static_cast<EventQueue*>(usr);
+    auto self=static_cast<EventCapture*>(usr);
     try {
         unsigned mask = 1u<<prio;
         Guard G(self->log->lock);
         assert(self->changing & mask);
         self->changing &= ~mask;
 
+        if(!self->changing && self->published!=self->done) {
+            // completed while scanning
+            self->published = self->done;
+            self->changing = shardScanRequest(self->onChange);
+        }
+
     }catch(std::exception& e){
         errlogPrintf("%s: " ERL_ERROR ": %s\n", __func__, e.what());
     }
@@ -336,7 +1582,9 @@ long eventLogSetMult(aoRecord *prec) noexcept
 
         Guard G(log->lock);
 
-        log->nsecPerTick = prec->val;
+        log->nsecNominal = prec->val;
+        if(!log->ticksPerSec)
+            log->nsecPerTick = prec->val;
         // TODO: auto-clear?
 
         return 0;
@@ -350,13 +1598,15 @@ long eventLogClear(longoutRecord *prec) noexcept {
         {
             Guard G(queue->log->lock);
 
-            if(!prec->val || queue->que.empty())
+            if(!prec->val || (queue->que.empty() && !queue->nFill))
                 return 0;
 
             // move all queued to unused, append to end
             queue->unused.splice(queue->unused.end(), queue->que);
+            queue->nFill = queue->fillStart = 0u;
+
+            queue->requestScan();
         }
-        scanIoRequest(queue->onChange);
 
         return 0;
     } CATCH
@@ -387,49 +1637,199 @@ long eventLogInitRecordOutBuf(dbCommon *pcom) noexcept
         Guard G(queue->log->lock);
         assert(queue->que.empty());
 
-        if(queue->unused.size() < prec->nelm)
-            queue->unused.resize(prec->nelm);
+        switch(prec->ftvl) {
+        case menuFtypeDOUBLE:
+            pvt->fmt = EventDev::Rel;
+            break;
+        case menuFtypeINT64:
+            pvt->fmt = EventDev::Abs;
+            break;
+        case menuFtypeULONG:
+            if(pvt->col==EventDev::Sec) {
+                pvt->fmt = EventDev::ASec;
+            } else if(pvt->col==EventDev::Nsec) {
+                pvt->fmt = EventDev::ANsec;
+            } else {
+                throw std::runtime_error("FTVL=ULONG requires col=sec or col=ns");
+            }
+            break;
+        default:
+            throw std::runtime_error("FTVL must be DOUBLE, INT64, or ULONG");
+        }
+
+        if(pvt->group) {
+            if(!pvt->autoclear)
+                throw std::runtime_error("group=yes requires autoclear=yes");
+
+            if(!queue->group) {
+                if(queue->listed || queue->columnar)
+                    throw std::runtime_error("Queue used with both group=yes and group=no");
+                queue->group = true;
+                queue->groupIdx = queue->log->grouped.size();
+                queue->log->grouped.push_back(queue);
+            }
+
+        } else if(queue->group) {
+            throw std::runtime_error("Queue used with both group=yes and group=no");
+        }
+
+        {
+            EventLink lnk(pcom);
+            if(lnk.dropOldest)
+                queue->dropOldest = true;
+            if(lnk.every>1u)
+                queue->every = lnk.every;
+            if(lnk.limit)
+                queue->limit = lnk.limit;
+            if(lnk.period)
+                queue->period = lnk.period;
+        }
+
+        if(pvt->fmt==EventDev::Rel) {
+            queue->listed = true;
+            if(queue->unused.size() < prec->nelm)
+                queue->unused.resize(prec->nelm);
+
+        } else {
+            if(!pvt->autoclear)
+                throw std::runtime_error("FTVL=INT64 and ULONG require autoclear=yes");
+
+            queue->columnar = true;
+            queue->nCol = std::max(queue->nCol, size_t(prec->nelm));
+            switch(pvt->fmt) {
+            case EventDev::Abs: queue->fillAbs = true; break;
+            case EventDev::ASec: queue->fillSec = true; break;
+            case EventDev::ANsec: queue->fillNsec = true; break;
+            case EventDev::Rel: break;
+            }
+
+            // BPTR is swapped for a Column shared with other records.  So
+            // reject client puts, and keep our own buffer for when nothing
+            // is published.
+            pvt->ownBptr = prec->bptr;
+            prec->disp = 1;
+        }
+
+        if(queue->columnar) {
+            // time of oldest after overwrite needs both sec and ns
+            if(queue->dropOldest && !(queue->fillSec && queue->fillNsec))
+                queue->fillAbs = true;
+            if(queue->fillAbs)
+                queue->colAbs.reserve(queue->nCol);
+            if(queue->fillSec)
+                queue->colSec.reserve(queue->nCol);
+            if(queue->fillNsec)
+                queue->colNsec.reserve(queue->nCol);
+        }
 
         return 0;
     } CATCH
 }
 
-long eventLogOutBuf(aaiRecord *prec) noexcept
+template<typename T>
+void eventLogSwapBuf(aaiRecord *prec, EventDev *pvt, const std::shared_ptr<T>& col)
 {
-    if(prec->ftvl!=menuFtypeDOUBLE) {
-        recGblSetSevrMsg(prec, WRITE_ALARM, INVALID_ALARM, "Bad FTVL");
-        return -1;
-    }
+    pvt->ref = col;
+    if(col)
+        prec->bptr = col->data();
+}
 
+// copy DOUBLE relative times.  Returns first element not copied (maybe end)
+std::list<epicsTime>::const_iterator eventLogOutRel(aaiRecord *prec, const std::list<epicsTime>& que)
+{
     auto val = static_cast<double*>(prec->bptr);
 
+    if(que.empty()) {
+        // leave TIME
+        prec->nord = 0;
+        return que.end();
+    }
+
+    auto& t0 = que.front();
+    prec->time = t0;
+
+    epicsUInt32 n = 0u;
+
+    auto it(que.begin()),
+        end(que.end());
+
+    for(; n<prec->nelm && it!=end; n++, ++it) {
+        auto& t = *it;
+        val[n] = t-t0;
+    }
+
+    prec->nord = n;
+    return it;
+}
+
+// swap in published INT64/ULONG column
+void eventLogOutCol(aaiRecord *prec, EventDev *pvt, const Published& queue)
+{
+    if(!queue.n) {
+        // leave TIME.  Release any shared Column
+        pvt->ref.reset();
+        prec->bptr = pvt->ownBptr;
+        prec->nord = 0;
+        return;
+    }
+
+    switch(pvt->fmt) {
+    case EventDev::Abs:
+        eventLogSwapBuf(prec, pvt, queue.colAbs);
+        break;
+    case EventDev::ASec:
+        eventLogSwapBuf(prec, pvt, queue.colSec);
+        break;
+    case EventDev::ANsec:
+        eventLogSwapBuf(prec, pvt, queue.colNsec);
+        break;
+    case EventDev::Rel:
+        break;
+    }
+    prec->time = queue.first;
+    prec->nord = std::min(queue.n, size_t(prec->nelm));
+}
+
+long eventLogOutBuf(aaiRecord *prec) noexcept
+{
     TRY {
         auto queue = pvt->queue;
+        auto log = queue->log;
 
-        Guard G(queue->log->lock);
+        if(pvt->group) {
+            // Snapshot of all grouped queues is immutable, and only replaced
+            // before an onBatch scan pass.  So no lock.
+            auto snap(std::atomic_load(&log->groupSnap));
+            if(!snap || queue->groupIdx >= snap->queues.size()) {
+                prec->nord = 0; // no batch yet
+                return 0;
+            }
+            auto& que = snap->queues[queue->groupIdx];
 
-        if(queue->que.empty()) {
-            // leave TIME
-            prec->nord = 0;
+            prec->utag = snap->epoch;
+            if(pvt->fmt==EventDev::Rel) {
+                (void)eventLogOutRel(prec, que.times);
+            } else {
+                eventLogOutCol(prec, pvt, que.published);
+            }
             return 0;
         }
 
-        auto& t0 = queue->que.front();
-        prec->time = t0;
+        CountingGuard G(log->lock, log->nReadWaits);
 
-        epicsUInt32 n = 0u;
+        prec->utag = log->epoch;
 
-        auto it(queue->que.begin()),
-            end(queue->que.end());
+        if(pvt->fmt!=EventDev::Rel) {
+            // all records of this queue processed in one scan pass see the same events
+            if(queue->needPublish || !queue->changing)
+                queue->publish();
 
-        for(; n<prec->nelm && it!=end; n++, ++it) {
-            auto& t = *it;
-            val[n] = t-t0;
+            eventLogOutCol(prec, pvt, queue->published);
+            return 0;
         }
 
-        prec->nord = n;
+        auto it(eventLogOutRel(prec, queue->que));
 
-        // it points to first element not copied (maybe end)
         if(pvt->autoclear) {
             // move [begin, it) -> unused (append)
             queue->unused.splice(queue->unused.end(),
@@ -442,6 +1842,293 @@ long eventLogOutBuf(aaiRecord *prec) noexcept
     } CATCH
 }
 
+long eventLogOutEpoch(longinRecord *prec) noexcept
+{
+    TRY {
+        auto snap(std::atomic_load(&pvt->queue->log->groupSnap));
+        auto epoch = snap ? snap->epoch : 0u;
+
+        prec->val = epicsInt32(epoch);
+        prec->utag = epoch;
+
+        return 0;
+    } CATCH
+}
+
+long eventLogInitRecordDiscipline(dbCommon *prec) noexcept {
+    auto stat = eventLogInitRecord(prec);
+    if(stat)
+        return stat;
+
+    TRY {
+        EventLink lnk(prec);
+        auto log = pvt->queue->log;
+
+        Guard G(log->lock);
+        log->discWindow = lnk.window;
+        log->discPPM = lnk.ppm;
+        log->discCode = lnk.code;
+        log->discGap = lnk.gap;
+
+        return 0;
+    } CATCH
+}
+
+long eventLogDiscipline(longoutRecord *prec) noexcept
+{
+    TRY {
+        auto log = pvt->queue->log;
+
+        Guard G(log->lock);
+
+        bool enable = prec->val!=0;
+        if(enable!=log->discipline) {
+            log->discipline = enable;
+            log->resetDiscipline();
+        }
+
+        return 0;
+    } CATCH
+}
+
+long eventLogFreq(aiRecord *prec) noexcept
+{
+    TRY {
+        auto log = pvt->queue->log;
+
+        Guard G(log->lock);
+
+        if(!log->ticksPerSec) {
+            recGblSetSevrMsg(prec, READ_ALARM, INVALID_ALARM, "No estimate");
+            return -1;
+        }
+
+        switch(pvt->stat) {
+        case EventDev::Freq:
+            prec->val = log->ticksPerSec*1e-6;
+            break;
+        case EventDev::Corr:
+            prec->val = (log->ticksPerSec*log->nsecNominal*1e-9 - 1.0)*1e6;
+            break;
+        default:
+            throw std::runtime_error("stat= not applicable");
+        }
+
+        return 2; // no conversion
+    } CATCH
+}
+
+long eventLogMergeStat(longinRecord *prec) noexcept
+{
+    TRY {
+        auto log = pvt->queue->log;
+
+        Guard G(log->lock);
+
+        switch(pvt->stat) {
+        case EventDev::Late: prec->val = epicsInt32(log->nLate); break;
+        case EventDev::Reordered: prec->val = epicsInt32(log->nReordered); break;
+        case EventDev::Held: prec->val = epicsInt32(log->nHeld); break;
+        case EventDev::MaxHeld: prec->val = epicsInt32(log->maxHeld); break;
+        case EventDev::Events: prec->val = epicsInt32(log->nEvents); break;
+        default:
+            throw std::runtime_error("stat= must be 'late', 'reordered', 'held', 'maxHeld', or 'events'");
+        }
+
+        return 0;
+    } CATCH
+}
+
+long eventLogQueueStat(longinRecord *prec) noexcept
+{
+    TRY {
+        auto queue = pvt->queue;
+
+        Guard G(queue->log->lock);
+
+        switch(pvt->stat) {
+        case EventDev::Overflows: prec->val = epicsInt32(queue->nOverflows); break;
+        case EventDev::Decimated: prec->val = epicsInt32(queue->nDecimated); break;
+        case EventDev::Suppressed: prec->val = epicsInt32(queue->nSuppressed); break;
+        case EventDev::Occur: prec->val = epicsInt32(queue->nOccur); break;
+        case EventDev::MaxFill: prec->val = epicsInt32(queue->maxFill); break;
+        default:
+            throw std::runtime_error("stat= must be 'overflows', 'decimated', 'suppressed', 'occur', or 'maxFill'");
+        }
+        prec->time = queue->last;
+
+        return 0;
+    } CATCH
+}
+
+long eventLogDbEventLatency(aiRecord *prec) noexcept
+{
+    TRY {
+        auto now = epicsMonotonicGet();
+        auto log = pvt->queue->log;
+        auto code = pvt->code;
+
+        if(!code)
+            throw std::runtime_error("Missing code=");
+
+        Guard G(log->lock);
+
+        if(!log->dbEvents[code])
+            throw std::runtime_error("code= not selected by dbevent=");
+        if(!log->dbEventPosted[code])
+            throw std::runtime_error("Not yet posted");
+
+        double lat = (now - log->dbEventPosted[code])*1e-9;
+        auto& max = log->dbEventMaxLat[code];
+        max = std::max(max, lat);
+
+        switch(pvt->stat) {
+        case EventDev::LatLast: prec->val = lat; break;
+        case EventDev::LatMax: prec->val = max; break;
+        default:
+            throw std::runtime_error("stat= must be 'last' or 'max'");
+        }
+
+        return 2; // no conversion
+    } CATCH
+}
+
+long eventCaptureInitRecord(dbCommon *prec) noexcept {
+    try {
+        EventLink lnk(prec);
+
+        auto capture(EventCapture::getCreate(lnk.logName, lnk.captureName));
+        auto pvt = new EventDev(prec, nullptr);
+        pvt->capture = capture;
+        pvt->col = lnk.col;
+        pvt->idx = lnk.idx;
+        prec->dpvt = (void*)pvt;
+
+        return 0;
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", prec->name, e.what());
+        return -1;
+    }
+}
+
+long eventCaptureInitRecordSet(dbCommon *prec) noexcept {
+    auto stat = eventCaptureInitRecord(prec);
+    if(stat)
+        return stat;
+
+    TRY {
+        EventLink lnk(prec);
+        auto capture = pvt->capture;
+        auto log = capture->log;
+        Guard G(log->lock);
+
+        capture->nPre = lnk.pre;
+        capture->nPost = lnk.post;
+        capture->nKeep = lnk.keep;
+
+        if(log->history.size() < lnk.pre) {
+            log->history.resize(lnk.pre);
+            log->historyNext = log->historyCount = 0u;
+        }
+
+        return 0;
+    } CATCH
+}
+
+long eventCaptureChanged(int detach, struct dbCommon *prec, IOSCANPVT* pscan) noexcept
+{
+    (void)detach;
+    auto pvt = static_cast<EventDev*>(prec->dpvt);
+    if(!pvt)
+        return -1;
+
+    *pscan = pvt->capture->onChange.scan;
+    return 0;
+}
+
+long eventCaptureSetEvent(longoutRecord *prec) noexcept
+{
+    if(prec->val<0 || prec->val>255)
+        prec->val = 0;
+
+    TRY {
+        auto capture = pvt->capture;
+        auto log = capture->log;
+        Guard G(log->lock);
+
+        auto& capturing = log->capturing;
+        capturing.erase(std::remove(capturing.begin(), capturing.end(), capture),
+                        capturing.end());
+        // abandon any capture in progress
+        capture->pending.reset();
+        capture->remaining = 0u;
+
+        capture->trigger = prec->val;
+        if(capture->trigger)
+            capturing.push_back(capture);
+
+        return 0;
+    } CATCH
+}
+
+long eventCaptureCount(longinRecord *prec) noexcept
+{
+    TRY {
+        auto capture = pvt->capture;
+        Guard G(capture->log->lock);
+
+        prec->val = epicsInt32(capture->nCaptures);
+        if(!capture->published.empty())
+            prec->time = capture->published.front()->trigger;
+
+        return 0;
+    } CATCH
+}
+
+long eventCaptureRead(aaiRecord *prec) noexcept
+{
+    if(prec->ftvl!=menuFtypeULONG) {
+        recGblSetSevrMsg(prec, READ_ALARM, INVALID_ALARM, "Bad FTVL");
+        return -1;
+    }
+
+    auto val = static_cast<epicsUInt32*>(prec->bptr);
+
+    TRY {
+        auto capture = pvt->capture;
+        Guard G(capture->log->lock);
+
+        if(pvt->idx >= capture->published.size()) {
+            // leave TIME
+            prec->nord = 0;
+            return 0;
+        }
+
+        auto& cap = *capture->published[pvt->idx];
+        prec->time = cap.trigger;
+
+        epicsUInt32 n = 0u;
+        for(; n<prec->nelm && n<cap.events.size(); n++) {
+            auto& rec = cap.events[n];
+            switch(pvt->col) {
+            case EventDev::Code:
+                val[n] = rec.code;
+                break;
+            case EventDev::Sec:
+                val[n] = rec.ts.secPastEpoch + POSIX_TIME_AT_EPICS_EPOCH;
+                break;
+            case EventDev::Nsec:
+                val[n] = rec.ts.nsec;
+                break;
+            }
+        }
+
+        prec->nord = n;
+
+        return 0;
+    } CATCH
+}
+
 aaodset devEventTableInput = {
     {5, nullptr, nullptr, eventLogInitRecord, nullptr},
     eventLogInput,
@@ -466,14 +2153,78 @@ aaidset devEventTableBuf = {
     {5, nullptr, nullptr, eventLogInitRecordOutBuf, eventTableChanged},
     eventLogOutBuf,
 };
+longindset devEventTableEpoch = {
+    {5, nullptr, nullptr, eventLogInitRecord, eventTableBatch},
+    eventLogOutEpoch,
+};
+longoutdset devEventTableDiscipline = {
+    {5, nullptr, nullptr, eventLogInitRecordDiscipline, nullptr},
+    eventLogDiscipline,
+};
+aidset devEventTableFreq = {
+    {6, nullptr, nullptr, eventLogInitRecord, eventTableDiscipline},
+    eventLogFreq, nullptr,
+};
+aidset devEventTableDbEventLatency = {
+    {6, nullptr, nullptr, eventLogInitRecord, nullptr},
+    eventLogDbEventLatency, nullptr,
+};
+longindset devEventTableMergeStat = {
+    {5, nullptr, nullptr, eventLogInitRecord, nullptr},
+    eventLogMergeStat,
+};
+longindset devEventTableQueueStat = {
+    {5, nullptr, nullptr, eventLogInitRecord, eventTableChanged},
+    eventLogQueueStat,
+};
+longoutdset devEventTableSetCapture = {
+    {5, nullptr, nullptr, eventCaptureInitRecordSet, nullptr},
+    eventCaptureSetEvent,
+};
+longindset devEventTableCaptureCount = {
+    {5, nullptr, nullptr, eventCaptureInitRecord, eventCaptureChanged},
+    eventCaptureCount,
+};
+aaidset devEventTableCapture = {
+    {5, nullptr, nullptr, eventCaptureInitRecord, eventCaptureChanged},
+    eventCaptureRead,
+};
 
 } // namespace
 
+namespace ospreyTiming {
+
+void eventLogAttach(const std::string& logName, EventLogObserver* obs)
+{
+    auto log(EventLog::getCreate(logName));
+    Guard G(log->lock);
+    log->observers.push_back(obs);
+}
+
+double eventLogNsecPerTick(const std::string& logName)
+{
+    auto log(EventLog::getCreate(logName));
+    Guard G(log->lock);
+    return log->nsecPerTick;
+}
+
+} // namespace ospreyTiming
+
 extern "C" {
+epicsExportAddress(drvet, drvEventTable);
 epicsExportAddress(dset, devEventTableInput);
 epicsExportAddress(dset, devEventTableSetEvent);
 epicsExportAddress(dset, devEventTableSetMult);
 epicsExportAddress(dset, devEventTableClear);
 epicsExportAddress(dset, devEventTableLast);
 epicsExportAddress(dset, devEventTableBuf);
+epicsExportAddress(dset, devEventTableEpoch);
+epicsExportAddress(dset, devEventTableDiscipline);
+epicsExportAddress(dset, devEventTableFreq);
+epicsExportAddress(dset, devEventTableMergeStat);
+epicsExportAddress(dset, devEventTableDbEventLatency);
+epicsExportAddress(dset, devEventTableQueueStat);
+epicsExportAddress(dset, devEventTableSetCapture);
+epicsExportAddress(dset, devEventTableCaptureCount);
+epicsExportAddress(dset, devEventTableCapture);
 }
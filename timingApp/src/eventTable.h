@@ -0,0 +1,100 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* Event RX table de-mux, internal interface
+ *
+ * Allows other parts of this library to observe the decoded
+ * event stream of an EventLog.  cf. eventTable.cpp
+ */
+#ifndef EVENTTABLE_H
+#define EVENTTABLE_H
+
+#include <string>
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <math.h>
+
+#include <epicsTime.h>
+#include <epicsMath.h>
+
+namespace ospreyTiming {
+
+// one decoded event
+struct EventRec {
+    epicsTimeStamp ts;
+    uint8_t code;
+};
+
+struct EventLogObserver {
+    virtual ~EventLogObserver() {}
+    /* Called once per Event Table Input batch, in dispatch order, with the
+     * EventLog lock held.  Must not block, or call back into the EventLog.
+     * Dispatch order is arrival order, or timestamp order for merged inputs
+     * (src=).
+     */
+    virtual void onEvents(const EventRec* recs, size_t nrecs) =0;
+};
+
+// (later - earlier) in nanoseconds
+inline
+int64_t diffNS(const epicsTimeStamp& later, const epicsTimeStamp& earlier)
+{
+    return (int64_t(later.secPastEpoch) - int64_t(earlier.secPastEpoch))*1000000000
+            + (int64_t(later.nsec) - int64_t(earlier.nsec));
+}
+
+/* Running statistics of one measurement, eg. a latency in ns.
+ * Mean and variance by Welford's method.
+ */
+struct RunningStat {
+    uint32_t n = 0u;
+    double last = 0.0, mean = 0.0, m2 = 0.0, min = 0.0, max = 0.0;
+
+    enum stat_t {
+        Last, Mean, Std, Min, Max, Count,
+    };
+
+    void add(double x) {
+        n++;
+        last = x;
+        if(n==1u) {
+            min = max = x;
+        } else {
+            if(x < min)
+                min = x;
+            if(x > max)
+                max = x;
+        }
+        double delta = x - mean;
+        mean += delta/n;
+        m2 += delta*(x - mean);
+    }
+
+    // NaN until defined
+    double value(stat_t stat) const {
+        switch(stat) {
+        case Last: if(n) return last; break;
+        case Mean: if(n) return mean; break;
+        case Std: if(n>1u) return sqrt(m2/(n-1u)); break;
+        case Min: if(n) return min; break;
+        case Max: if(n) return max; break;
+        case Count: return n;
+        }
+        return epicsNAN;
+    }
+};
+
+/* Attach to named EventLog, created if necessary.  Observers are never
+ * detached and must remain valid until process exit.
+ */
+void eventLogAttach(const std::string& logName, EventLogObserver* obs);
+
+// Current tick scale of named EventLog, created if necessary.
+double eventLogNsecPerTick(const std::string& logName);
+
+} // namespace ospreyTiming
+
+#endif // EVENTTABLE_H
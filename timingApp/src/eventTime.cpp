@@ -0,0 +1,126 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* generalTime event provider from an EventLog
+ *
+ * Remembers the most recent timestamp of each event code received by one
+ * EventLog.  Allows any record to use TSE=<event code>.
+ *
+ *   eventTimeProvider("LOGNAME", 50)
+ *
+ * before iocInit.
+ */
+
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <atomic>
+
+#include <stdint.h>
+
+#include <epicsTypes.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsStdio.h>
+#include <epicsTime.h>
+#include <generalTimeSup.h>
+#include <iocsh.h>
+#include <errlog.h>
+
+#include <epicsExport.h>
+
+#include "eventTable.h"
+
+namespace {
+using namespace ospreyTiming;
+
+typedef epicsGuard<epicsMutex> Guard;
+
+struct EventTimeTable : public EventLogObserver {
+    /* (secPastEpoch<<32 | nsec) of most recent occurrence, or zero if never seen.
+     * Packed so that readers see a consistent pair without locking.
+     */
+    std::atomic<uint64_t> last[256];
+
+    EventTimeTable()
+    {
+        for(auto& ent : last)
+            ent.store(0u, std::memory_order_relaxed);
+    }
+    virtual ~EventTimeTable() {}
+
+    virtual void onEvents(const EventRec* recs, size_t nrecs) override final
+    {
+        for(size_t i=0u; i<nrecs; i++) {
+            auto& rec = recs[i];
+            last[rec.code].store((uint64_t(rec.ts.secPastEpoch)<<32u) | rec.ts.nsec,
+                                 std::memory_order_release);
+        }
+    }
+};
+
+epicsMutex providerLock;
+// only one generalTime provider per process.  Never free'd.
+EventTimeTable* provider;
+
+int eventTimeGet(epicsTimeStamp *pDest, int event)
+{
+    // current time (0), best time (-1), and device time (-2) from elsewhere
+    if(event<1 || event>255)
+        return epicsTimeERROR;
+
+    auto tbl = provider; // set before registration
+    uint64_t val = tbl->last[event].load(std::memory_order_acquire);
+    if(!val)
+        return epicsTimeERROR; // not yet seen, defer to lower priority provider
+
+    pDest->secPastEpoch = epicsUInt32(val>>32u);
+    pDest->nsec = epicsUInt32(val);
+    return epicsTimeOK;
+}
+
+void eventTimeProvider(const char *logName, int priority)
+{
+    try {
+        if(!logName || !logName[0])
+            throw std::runtime_error("Missing log name");
+
+        Guard G(providerLock);
+        if(provider)
+            throw std::runtime_error("Event time provider already registered");
+
+        std::unique_ptr<EventTimeTable> tbl(new EventTimeTable);
+        eventLogAttach(logName, tbl.get());
+        provider = tbl.release();
+
+        if(generalTimeRegisterEventProvider("EventLog", priority, eventTimeGet))
+            throw std::runtime_error("Unable to register generalTime provider");
+
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", __func__, e.what());
+    }
+}
+
+const iocshArg eventTimeProviderArg0 = {"log", iocshArgString};
+const iocshArg eventTimeProviderArg1 = {"priority", iocshArgInt};
+const iocshArg * const eventTimeProviderArgs[] = {&eventTimeProviderArg0, &eventTimeProviderArg1};
+const iocshFuncDef eventTimeProviderDef = {"eventTimeProvider", 2, eventTimeProviderArgs,
+                                           "Use event timestamps from named Event Table log for TSE>0.\n"
+                                           "Priority is typically 50.\n"};
+
+void eventTimeProviderCall(const iocshArgBuf *args)
+{
+    eventTimeProvider(args[0].sval, args[1].ival);
+}
+
+void eventTimeRegistrar()
+{
+    iocshRegister(&eventTimeProviderDef, eventTimeProviderCall);
+}
+
+} // namespace
+
+extern "C" {
+epicsExportRegistrar(eventTimeRegistrar);
+}
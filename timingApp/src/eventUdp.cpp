@@ -0,0 +1,417 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* UDP/multicast publisher of decoded events from an EventLog
+ *
+ * Sender side of the datagram stream described in eventUdp.h
+ *
+ *   eventUdpPublish("EVR1:UDP", "EVR1:LOG", "239.1.2.3:5100", 1, "", 8192)
+ *
+ * before iocInit.  Ingest only copies events into a lock-free queue.
+ * A dedicated thread batches and sends.  When the queue is full, new
+ * events are dropped and counted.
+ *
+ * Output:
+ *   - event, datagram, byte, drop, and error counts, and send rate (ai)
+ */
+
+#include <map>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <atomic>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <osiSock.h>
+
+#define USE_TYPED_RSET
+#define USE_TYPED_DSET
+
+#include <epicsTypes.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsEvent.h>
+#include <epicsThread.h>
+#include <epicsString.h>
+#include <epicsStdio.h>
+#include <epicsTime.h>
+#include <epicsMonotonic.h>
+#include <iocsh.h>
+#include <errlog.h>
+
+#include <alarm.h>
+#include <dbAccess.h>
+#include <devSup.h>
+#include <recGbl.h>
+#include <dbCommon.h>
+#include <aiRecord.h>
+
+#include <epicsExport.h>
+
+#include "eventTable.h"
+#include "eventUdp.h"
+
+namespace {
+using namespace ospreyTiming;
+
+typedef epicsGuard<epicsMutex> Guard;
+
+struct EventUdpPublisher : public EventLogObserver, public epicsThreadRunable {
+    const std::string name;
+
+    SOCKET sock;
+    osiSockAddr dest;
+
+    /* single producer (onEvents(), EventLog lock held)
+     * single consumer (worker)
+     */
+    struct Item {
+        EventRec evt;
+        uint64_t seq;
+    };
+    std::vector<Item> ring;
+    const uint64_t mask; // capacity-1
+    std::atomic<uint64_t> wr{0u}, rd{0u};
+    uint64_t nextSeq = 1u; // producer only
+
+    // statistics
+    std::atomic<uint64_t> nEvents{0u}, nDatagrams{0u}, nBytes{0u}, nDropped{0u}, nErrors{0u};
+
+    // worker only
+    uint64_t datagramSeq = 0u;
+    int lastError = 0;
+
+    epicsEvent wakeup;
+    epicsThread worker;
+
+    EventUdpPublisher(const std::string& name, SOCKET sock, const osiSockAddr& dest, uint32_t capacity)
+        :name(name)
+        ,sock(sock)
+        ,dest(dest)
+        ,ring(capacity)
+        ,mask(capacity-1u)
+        ,worker(*this, ("UDP:" + name).c_str(),
+                epicsThreadGetStackSize(epicsThreadStackSmall),
+                epicsThreadPriorityMedium)
+    {}
+    virtual ~EventUdpPublisher() {}
+
+    virtual void onEvents(const EventRec* evts, size_t nevts) override final
+    {
+        auto w = wr.load(std::memory_order_relaxed);
+        auto r = rd.load(std::memory_order_acquire);
+
+        for(size_t i=0u; i<nevts; i++) {
+            auto seq = nextSeq++;
+            if(w - r > mask) {
+                r = rd.load(std::memory_order_acquire);
+                if(w - r > mask) {
+                    nDropped.fetch_add(1u, std::memory_order_relaxed);
+                    continue;
+                }
+            }
+            ring[w & mask] = Item{evts[i], seq};
+            w++;
+        }
+
+        wr.store(w, std::memory_order_release);
+        if(nevts)
+            wakeup.trigger();
+    }
+
+    void send(const std::vector<char>& buf, uint64_t first, unsigned count)
+    {
+        eventUdpHeader hdr;
+        hdr.magic = htonl(EVENTUDP_MAGIC);
+        hdr.version = htons(EVENTUDP_VERSION);
+        hdr.count = htons(count);
+        hdr.seqHi = htonl(uint32_t(datagramSeq>>32u));
+        hdr.seqLo = htonl(uint32_t(datagramSeq));
+        hdr.firstHi = htonl(uint32_t(first>>32u));
+        hdr.firstLo = htonl(uint32_t(first));
+        hdr.dropped = htonl(uint32_t(nDropped.load(std::memory_order_relaxed)));
+        hdr.reserved = 0u;
+        memcpy((void*)buf.data(), &hdr, sizeof(hdr));
+
+        size_t len = sizeof(hdr) + count*sizeof(eventUdpRecord);
+        int ret = sendto(sock, buf.data(), len, 0, &dest.sa, sizeof(dest));
+        datagramSeq++;
+
+        if(ret==int(len)) {
+            nEvents.fetch_add(count, std::memory_order_relaxed);
+            nDatagrams.fetch_add(1u, std::memory_order_relaxed);
+            nBytes.fetch_add(len, std::memory_order_relaxed);
+            lastError = 0;
+
+        } else {
+            nErrors.fetch_add(1u, std::memory_order_relaxed);
+            int err = ret<0 ? SOCKERRNO : 0;
+            if(err!=lastError) {
+                errlogPrintf("%s : send error (%d) %s\n",
+                             name.c_str(), err, err ? strerror(err) : "truncated");
+                lastError = err;
+            }
+        }
+    }
+
+    void run() override final
+    {
+        std::vector<char> buf(EVENTUDP_MAX_SIZE);
+        auto recs = reinterpret_cast<eventUdpRecord*>(&buf[sizeof(eventUdpHeader)]);
+
+        while(true) {
+            wakeup.wait();
+
+            auto r = rd.load(std::memory_order_relaxed);
+            auto w = wr.load(std::memory_order_acquire);
+
+            while(r!=w) {
+                // consecutive sequence numbers, up to a full datagram
+                auto first = ring[r & mask].seq;
+                unsigned n = 0u;
+                for(; r!=w && n<EVENTUDP_MAX_RECORDS && ring[r & mask].seq==first+n; r++, n++) {
+                    auto& evt = ring[r & mask].evt;
+                    auto& rec = recs[n];
+                    rec.sec = htonl(evt.ts.secPastEpoch + POSIX_TIME_AT_EPICS_EPOCH);
+                    rec.nsec = htonl(evt.ts.nsec);
+                    rec.code = evt.code;
+                    memset(rec.reserved, 0, sizeof(rec.reserved));
+                }
+                // release slots before the (slow) send
+                rd.store(r, std::memory_order_release);
+
+                send(buf, first, n);
+
+                w = wr.load(std::memory_order_acquire);
+            }
+        }
+    }
+};
+
+epicsMutex publishersLock;
+// guarded by publishersLock.  Never free'd.
+std::map<std::string, EventUdpPublisher*> publishers;
+
+struct UdpDev {
+    EventUdpPublisher* const pub;
+
+    enum stat_t {
+        Events, Datagrams, Bytes, Dropped, Errors, Rate,
+    } stat = Events;
+
+    // for Rate
+    uint64_t prevEvents = 0u;
+    uint64_t prevTime = 0u;
+
+    explicit UdpDev(EventUdpPublisher* pub)
+        :pub(pub)
+    {}
+};
+
+long eventUdpInitRecord(dbCommon *prec) noexcept {
+    try {
+        auto plink(dbGetDevLink(prec));
+        assert(plink->type==INST_IO);
+        std::string lstr(plink->value.instio.string);
+
+        std::string name;
+        UdpDev::stat_t stat = UdpDev::Events;
+
+        char *saved = nullptr;
+        for(char* word = epicsStrtok_r((char*)lstr.data(), " ", &saved)
+             ; word
+             ; word = epicsStrtok_r(NULL, " ", &saved))
+        {
+            auto wlen = strlen(word);
+
+            auto cmd = [=](const char *pref) -> const char* {
+                auto plen = strlen(pref);
+                if(wlen >= plen && memcmp(word, pref, plen)==0) {
+                    return word + plen;
+                }
+                return nullptr;
+            };
+
+            if(auto val = cmd("pub=")) {
+                name = val;
+
+            } else if(auto val = cmd("stat=")) {
+                if(epicsStrCaseCmp(val, "events")==0) {
+                    stat = UdpDev::Events;
+                } else if(epicsStrCaseCmp(val, "datagrams")==0) {
+                    stat = UdpDev::Datagrams;
+                } else if(epicsStrCaseCmp(val, "bytes")==0) {
+                    stat = UdpDev::Bytes;
+                } else if(epicsStrCaseCmp(val, "dropped")==0) {
+                    stat = UdpDev::Dropped;
+                } else if(epicsStrCaseCmp(val, "errors")==0) {
+                    stat = UdpDev::Errors;
+                } else if(epicsStrCaseCmp(val, "rate")==0) {
+                    stat = UdpDev::Rate;
+                } else {
+                    throw std::runtime_error("stat= must be 'events', 'datagrams', 'bytes', 'dropped', 'errors', or 'rate'");
+                }
+
+            } else {
+                throw std::runtime_error("Unexpected dev. link parameter");
+            }
+        }
+
+        EventUdpPublisher* pub;
+        {
+            Guard G(publishersLock);
+            auto it = publishers.find(name);
+            if(it==publishers.end())
+                throw std::runtime_error("No such pub=, see eventUdpPublish()");
+            pub = it->second;
+        }
+
+        auto pvt = new UdpDev(pub);
+        pvt->stat = stat;
+        pvt->prevTime = epicsMonotonicGet();
+        prec->dpvt = (void*)pvt;
+
+        return 0;
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", prec->name, e.what());
+        return -1;
+    }
+}
+
+long eventUdpRead(aiRecord *prec) noexcept
+{
+    if(!prec->dpvt) {
+        recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "No Init");
+        return -1;
+    }
+    auto pvt = static_cast<UdpDev*>(prec->dpvt);
+    auto pub = pvt->pub;
+
+    switch(pvt->stat) {
+    case UdpDev::Events: prec->val = pub->nEvents.load(); break;
+    case UdpDev::Datagrams: prec->val = pub->nDatagrams.load(); break;
+    case UdpDev::Bytes: prec->val = pub->nBytes.load(); break;
+    case UdpDev::Dropped: prec->val = pub->nDropped.load(); break;
+    case UdpDev::Errors: prec->val = pub->nErrors.load(); break;
+    case UdpDev::Rate: {
+        // events per second since previous read
+        auto now = epicsMonotonicGet();
+        auto nevts = pub->nEvents.load();
+        double dT = (now - pvt->prevTime)*1e-9;
+        prec->val = dT>0.0 ? (nevts - pvt->prevEvents)/dT : 0.0;
+        pvt->prevEvents = nevts;
+        pvt->prevTime = now;
+    }
+        break;
+    }
+
+    return 2; // no conversion
+}
+
+aidset devEventUdpStat = {
+    {6, nullptr, nullptr, eventUdpInitRecord, nullptr},
+    eventUdpRead, nullptr,
+};
+
+void eventUdpPublish(const char *name, const char *logName, const char *destName,
+                     int ttl, const char *iface, int capacity)
+{
+    SOCKET sock = INVALID_SOCKET;
+    try {
+        if(!name || !name[0])
+            throw std::runtime_error("Missing name");
+        if(!logName || !logName[0])
+            throw std::runtime_error("Missing log name");
+        if(capacity<=0)
+            capacity = 8192;
+        if(capacity & (capacity-1))
+            throw std::runtime_error("capacity must be a power of 2");
+
+        osiSockAttach();
+
+        osiSockAddr dest;
+        memset(&dest, 0, sizeof(dest));
+        if(!destName || aToIPAddr(destName, 0, &dest.ia) || dest.ia.sin_port==0)
+            throw std::runtime_error("Invalid destination, expect host:port");
+
+        sock = epicsSocketCreate(AF_INET, SOCK_DGRAM, 0);
+        if(sock==INVALID_SOCKET)
+            throw std::runtime_error("Unable to create socket");
+
+        if(IN_MULTICAST(ntohl(dest.ia.sin_addr.s_addr))) {
+            unsigned char mttl = ttl>0 ? ttl : 1;
+            if(setsockopt(sock, IPPROTO_IP, IP_MULTICAST_TTL, (char*)&mttl, sizeof(mttl)))
+                throw std::runtime_error("Unable to set IP_MULTICAST_TTL");
+
+            if(iface && iface[0]) {
+                osiSockAddr ifaddr;
+                memset(&ifaddr, 0, sizeof(ifaddr));
+                if(aToIPAddr(iface, 0, &ifaddr.ia))
+                    throw std::runtime_error("Invalid interface address");
+                if(setsockopt(sock, IPPROTO_IP, IP_MULTICAST_IF,
+                              (char*)&ifaddr.ia.sin_addr, sizeof(ifaddr.ia.sin_addr)))
+                    throw std::runtime_error("Unable to set IP_MULTICAST_IF");
+            }
+
+        } else if(ttl>0) {
+            int uttl = ttl;
+            if(setsockopt(sock, IPPROTO_IP, IP_TTL, (char*)&uttl, sizeof(uttl)))
+                throw std::runtime_error("Unable to set IP_TTL");
+        }
+
+        Guard G(publishersLock);
+        if(publishers.find(name)!=publishers.end())
+            throw std::runtime_error("Name already in use");
+
+        auto pub = new EventUdpPublisher(name, sock, dest, capacity);
+        sock = INVALID_SOCKET; // owned by pub
+        publishers[name] = pub;
+        pub->worker.start();
+
+        // never free'd
+        eventLogAttach(logName, pub);
+
+    } catch(std::exception& e){
+        if(sock!=INVALID_SOCKET)
+            epicsSocketDestroy(sock);
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", __func__, e.what());
+    }
+}
+
+const iocshArg eventUdpPublishArg0 = {"name", iocshArgString};
+const iocshArg eventUdpPublishArg1 = {"log", iocshArgString};
+const iocshArg eventUdpPublishArg2 = {"host:port", iocshArgString};
+const iocshArg eventUdpPublishArg3 = {"TTL", iocshArgInt};
+const iocshArg eventUdpPublishArg4 = {"interface", iocshArgString};
+const iocshArg eventUdpPublishArg5 = {"capacity", iocshArgInt};
+const iocshArg * const eventUdpPublishArgs[] = {
+    &eventUdpPublishArg0, &eventUdpPublishArg1, &eventUdpPublishArg2,
+    &eventUdpPublishArg3, &eventUdpPublishArg4, &eventUdpPublishArg5,
+};
+const iocshFuncDef eventUdpPublishDef = {"eventUdpPublish", 6, eventUdpPublishArgs,
+                                         "Send events of named Event Table log as UDP datagrams to a unicast or multicast address.\n"
+                                         "TTL 0 keeps the system default, 1 for multicast.\n"
+                                         "Optional interface address for multicast.\n"
+                                         "Queue capacity is a power of 2, default 8192.\n"
+                                         "cf. eventUdp.h\n"};
+
+void eventUdpPublishCall(const iocshArgBuf *args)
+{
+    eventUdpPublish(args[0].sval, args[1].sval, args[2].sval, args[3].ival, args[4].sval, args[5].ival);
+}
+
+void eventUdpRegistrar()
+{
+    iocshRegister(&eventUdpPublishDef, eventUdpPublishCall);
+}
+
+} // namespace
+
+extern "C" {
+epicsExportAddress(dset, devEventUdpStat);
+epicsExportRegistrar(eventUdpRegistrar);
+}
@@ -0,0 +1,61 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* UDP datagram stream of decoded events.  Public interface
+ *
+ * An IOC configured with
+ *
+ *   eventUdpPublish("NAME", "LOGNAME", "239.1.2.3:5100", 1, "", 8192)
+ *
+ * sends each event received by the named EventLog to a UDP unicast or
+ * multicast address.  Events are batched into datagrams of at most
+ * EVENTUDP_MAX_RECORDS records.  All fields are in network byte order.
+ *
+ *   eventUdpHeader
+ *   eventUdpRecord[count]
+ *
+ * Each event is assigned a sequence number.  Records in one datagram have
+ * consecutive sequence numbers, starting with 'first'.  Gaps between
+ * datagrams are events dropped by the publisher, or lost in the network.
+ * Datagram sequence numbers also increment by one.
+ */
+#ifndef EVENTUDP_H
+#define EVENTUDP_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EVENTUDP_MAGIC 0x4f455544ul /* "OEUD" */
+#define EVENTUDP_VERSION 1u
+#define EVENTUDP_MAX_RECORDS 100u
+
+typedef struct {
+    uint32_t magic;    /* EVENTUDP_MAGIC */
+    uint16_t version;  /* EVENTUDP_VERSION */
+    uint16_t count;    /* number of records following */
+    uint32_t seqHi;    /* datagram sequence number */
+    uint32_t seqLo;
+    uint32_t firstHi;  /* event sequence number of first record */
+    uint32_t firstLo;
+    uint32_t dropped;  /* events dropped by publisher, cumulative, wraps */
+    uint32_t reserved;
+} eventUdpHeader;
+
+typedef struct {
+    uint32_t sec;      /* seconds since POSIX epoch */
+    uint32_t nsec;
+    uint8_t code;      /* event code */
+    uint8_t reserved[3];
+} eventUdpRecord;
+
+#define EVENTUDP_MAX_SIZE (sizeof(eventUdpHeader) + EVENTUDP_MAX_RECORDS*sizeof(eventUdpRecord))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EVENTUDP_H */
@@ -0,0 +1,366 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* EVR output delay/width configuration
+ *
+ * Holds the delay and width (ns) of all outputs of one EVR, and the output
+ * resolution (ns per tick).  On (re)connect, or reference clock change,
+ * one record computes the tick values of all outputs in one pass, then
+ * re-applies every output through a single I/O Intr scan.  It completes
+ * only after all outputs have queued their register writes.
+ *
+ * Output:
+ *   - per output delay/width (ao), RVAL in ticks, I/O Intr to re-apply
+ *   - scale (ao, ns per tick), asynchronous until all outputs re-applied
+ */
+
+#include <map>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define USE_TYPED_RSET
+#define USE_TYPED_DSET
+
+#include <dbDefs.h>
+#include <epicsTypes.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsString.h>
+#include <epicsStdio.h>
+#include <errlog.h>
+
+#include <alarm.h>
+#include <callback.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <devSup.h>
+#include <recGbl.h>
+#include <dbCommon.h>
+#include <aoRecord.h>
+
+#include <epicsExport.h>
+
+namespace {
+
+typedef epicsGuard<epicsMutex> Guard;
+
+struct EvrOutputs;
+
+epicsMutex outputsLock;
+std::map<std::string, std::unique_ptr<EvrOutputs>> allOutputs;
+
+struct ScaleDev;
+
+struct EvrOutputs {
+    epicsMutex lock;
+
+    double nsPerTick = 0.0; // 0 until first scale
+    struct Output {
+        double delay = 0.0, width = 0.0; // ns
+        epicsInt32 delayTick = 0, widthTick = 0;
+    };
+    std::vector<Output> outputs; // [N-1]
+
+    IOSCANPVT onApply;
+    unsigned applying = 0u; // onApply scan priority mask in progress
+    bool reapply = false;   // scale changed while applying
+    std::vector<ScaleDev*> waiting; // scale records to complete
+
+    EvrOutputs()
+    {
+        scanIoInit(&onApply);
+        scanIoSetComplete(onApply, onApplyComplete, this);
+    }
+
+    static
+    EvrOutputs* getCreate(const std::string& name) {
+        Guard G(outputsLock);
+        auto& ent = allOutputs[name];
+        if(!ent)
+            ent.reset(new EvrOutputs);
+        return ent.get();
+    }
+
+    epicsInt32 ticks(double ns) const
+    {
+        if(nsPerTick<=0.0 || !(ns>0.0))
+            return 0;
+        double tick = ns/nsPerTick + 0.5;
+        if(tick >= double(0x7fffffff))
+            return 0x7fffffff;
+        return epicsInt32(tick);
+    }
+
+    // must lock
+    void setScale(double scale)
+    {
+        nsPerTick = scale;
+        for(auto& out : outputs) {
+            out.delayTick = ticks(out.delay);
+            out.widthTick = ticks(out.width);
+        }
+    }
+
+    static
+    void onApplyComplete(void *usr, IOSCANPVT, int prio) noexcept;
+};
+
+struct TimeDev {
+    EvrOutputs* const outs;
+    const size_t index;
+    const bool width;
+
+    TimeDev(EvrOutputs* outs, size_t index, bool width)
+        :outs(outs), index(index), width(width)
+    {}
+};
+
+struct ScaleDev {
+    aoRecord* const prec;
+    EvrOutputs* const outs;
+    epicsCallback done;
+
+    ScaleDev(aoRecord *prec, EvrOutputs* outs)
+        :prec(prec), outs(outs)
+    {
+        memset(&done, 0, sizeof(done));
+    }
+};
+
+void EvrOutputs::onApplyComplete(void *usr, IOSCANPVT, int prio) noexcept
+{
+    auto self=static_cast<EvrOutputs*>(usr);
+    try {
+        unsigned mask = 1u<<prio;
+        Guard G(self->lock);
+        assert(self->applying & mask);
+        self->applying &= ~mask;
+
+        if(self->applying)
+            return;
+
+        if(self->reapply) {
+            self->reapply = false;
+            self->applying = scanIoRequest(self->onApply);
+            if(self->applying)
+                return;
+        }
+
+        // all outputs have queued writes with the latest scale
+        for(auto pvt : self->waiting)
+            callbackRequestProcessCallback(&pvt->done, priorityLow, pvt->prec);
+        self->waiting.clear();
+
+    }catch(std::exception& e){
+        errlogPrintf("%s: " ERL_ERROR ": %s\n", __func__, e.what());
+    }
+}
+
+struct Link {
+    std::string outsName;
+    long index = 0;
+    bool width = false;
+};
+
+Link parseLink(dbCommon *prec)
+{
+    auto plink(dbGetDevLink(prec));
+    assert(plink->type==INST_IO);
+    std::string lstr(plink->value.instio.string);
+
+    Link ret;
+
+    char *saved = nullptr;
+    for(char* word = epicsStrtok_r((char*)lstr.data(), " ", &saved)
+         ; word
+         ; word = epicsStrtok_r(NULL, " ", &saved))
+    {
+        auto wlen = strlen(word);
+
+        auto cmd = [=](const char *pref) -> const char* {
+            auto plen = strlen(pref);
+            if(wlen >= plen && memcmp(word, pref, plen)==0) {
+                return word + plen;
+            }
+            return nullptr;
+        };
+
+        if(auto val = cmd("outs=")) {
+            ret.outsName = val;
+
+        } else if(auto val = cmd("out=")) {
+            ret.index = std::stol(val, nullptr, 0);
+            if(ret.index<1 || ret.index>64)
+                throw std::runtime_error("out= must be 1-64");
+
+        } else if(auto val = cmd("param=")) {
+            if(epicsStrCaseCmp(val, "delay")==0) {
+                ret.width = false;
+            } else if(epicsStrCaseCmp(val, "width")==0) {
+                ret.width = true;
+            } else {
+                throw std::runtime_error("param= must be 'delay' or 'width'");
+            }
+
+        } else {
+            throw std::runtime_error("Unexpected dev. link parameter");
+        }
+    }
+
+    if(ret.outsName.empty())
+        throw std::runtime_error("Missing outs=");
+
+    return ret;
+}
+
+long evrTimeInitRecord(dbCommon *pcommon) noexcept {
+    auto prec = reinterpret_cast<aoRecord*>(pcommon);
+    try {
+        auto lnk(parseLink(pcommon));
+        if(!lnk.index)
+            throw std::runtime_error("Missing out=");
+
+        auto outs = EvrOutputs::getCreate(lnk.outsName);
+        {
+            Guard G(outs->lock);
+            if(outs->outputs.size() < size_t(lnk.index))
+                outs->outputs.resize(lnk.index);
+
+            // restored by autosave
+            auto& out = outs->outputs[lnk.index-1];
+            if(lnk.width) {
+                out.width = prec->val;
+                out.widthTick = outs->ticks(out.width);
+            } else {
+                out.delay = prec->val;
+                out.delayTick = outs->ticks(out.delay);
+            }
+        }
+
+        prec->dpvt = (void*)new TimeDev(outs, lnk.index-1, lnk.width);
+
+        return 2; // keep VAL
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", prec->name, e.what());
+        return -1;
+    }
+}
+
+long evrScaleInitRecord(dbCommon *pcommon) noexcept {
+    auto prec = reinterpret_cast<aoRecord*>(pcommon);
+    try {
+        auto lnk(parseLink(pcommon));
+        if(lnk.index)
+            throw std::runtime_error("out= not applicable");
+
+        auto outs = EvrOutputs::getCreate(lnk.outsName);
+        prec->dpvt = (void*)new ScaleDev(prec, outs);
+
+        return 2; // no conversion
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", prec->name, e.what());
+        return -1;
+    }
+}
+
+long evrTimeApply(int detach, struct dbCommon *prec, IOSCANPVT* pscan) noexcept
+{
+    (void)detach;
+    auto pvt = static_cast<TimeDev*>(prec->dpvt);
+    if(!pvt)
+        return -1;
+
+    *pscan = pvt->outs->onApply;
+    return 0;
+}
+
+#define TRY(KLASS) \
+    if(!prec->dpvt) { \
+            recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "No Init"); \
+            return -1; \
+    } \
+    auto pvt = static_cast<KLASS*>(prec->dpvt); \
+    try
+
+#define CATCH \
+    catch(std::exception& e){ \
+        recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "%s", e.what()); \
+        if(prec->tpro) \
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", prec->name, e.what()); \
+        return -1; \
+}
+
+long evrTimeWrite(aoRecord *prec) noexcept
+{
+    TRY(TimeDev) {
+        auto outs = pvt->outs;
+        Guard G(outs->lock);
+
+        auto& out = outs->outputs[pvt->index];
+        if(pvt->width) {
+            out.width = prec->oval;
+            out.widthTick = outs->ticks(out.width);
+            prec->rval = out.widthTick;
+        } else {
+            out.delay = prec->oval;
+            out.delayTick = outs->ticks(out.delay);
+            prec->rval = out.delayTick;
+        }
+
+        if(outs->nsPerTick<=0.0)
+            recGblSetSevrMsg(prec, UDF_ALARM, INVALID_ALARM, "No scale");
+
+        return 0;
+    } CATCH
+}
+
+long evrScaleWrite(aoRecord *prec) noexcept
+{
+    TRY(ScaleDev) {
+        if(prec->pact)
+            return 0; // all outputs re-applied
+
+        if(!(prec->val>0.0) || !isfinite(prec->val))
+            throw std::runtime_error("Invalid scale");
+
+        auto outs = pvt->outs;
+        Guard G(outs->lock);
+
+        outs->setScale(prec->val);
+
+        if(outs->applying) {
+            outs->reapply = true;
+        } else {
+            outs->applying = scanIoRequest(outs->onApply);
+            if(!outs->applying)
+                return 0; // no outputs, or before iocInit
+        }
+
+        outs->waiting.push_back(pvt);
+        prec->pact = TRUE;
+        return 0;
+    } CATCH
+}
+
+aodset devEvrOutputTime = {
+    {6, nullptr, nullptr, evrTimeInitRecord, evrTimeApply},
+    evrTimeWrite, nullptr,
+};
+aodset devEvrOutputScale = {
+    {6, nullptr, nullptr, evrScaleInitRecord, nullptr},
+    evrScaleWrite, nullptr,
+};
+
+} // namespace
+
+extern "C" {
+epicsExportAddress(dset, devEvrOutputTime);
+epicsExportAddress(dset, devEvrOutputScale);
+}
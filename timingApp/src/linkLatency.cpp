@@ -0,0 +1,569 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* EVG to EVR link latency
+ *
+ * A probe event code is sent periodically, eg. through EVG:swEvent, or
+ * from a sequencer entry.  The receive timestamp of the probe code in the
+ * EventLog of each node is compared with a reference.  Either the
+ * timestamp in a reference EventLog (ref=), eg. the EVR co-located with
+ * the EVG, or the host time when the probe was fired.
+ *
+ * Each probe opens a cycle.  A node which has not seen the probe code
+ * when the next cycle opens counts as missed.
+ *
+ * With a reference log, a node may see the next probe before the
+ * reference log does, eg. when fired from a sequencer.  An arrival more
+ * than window= from the current reference is held for the next cycle.
+ *
+ * Output:
+ *   - per node last, mean, std. dev., min, max, count, missed (aai indexed by node)
+ *   - per node histogram of latency (aai)
+ */
+
+#include <map>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define USE_TYPED_RSET
+#define USE_TYPED_DSET
+
+#include <epicsTypes.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsString.h>
+#include <epicsStdio.h>
+#include <epicsTime.h>
+#include <epicsMath.h>
+#include <errlog.h>
+
+#include <alarm.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <devSup.h>
+#include <recGbl.h>
+#include <dbCommon.h>
+#include <aaiRecord.h>
+#include <longoutRecord.h>
+#include <menuFtype.h>
+
+#include <epicsExport.h>
+
+#include "eventTable.h"
+#include "scanShard.h"
+
+namespace {
+using namespace ospreyTiming;
+
+typedef epicsGuard<epicsMutex> Guard;
+
+struct LinkProbe;
+
+epicsMutex probesLock;
+std::map<std::string, std::unique_ptr<LinkProbe>> probes;
+
+struct LinkProbe {
+    epicsMutex lock;
+
+    uint8_t code = 0u; // 0 until configured
+    int64_t histMin = 0, histMax = 10000; // ns
+    size_t nbins = 64u;
+    int64_t window = 1000000; // ns.  match of node to reference log
+
+    struct Node {
+        std::string logName; // empty until attached
+
+        bool seen = false; // in this cycle
+        epicsTimeStamp ts;
+        bool early = false; // arrived before the reference of the next cycle
+        epicsTimeStamp earlyTs;
+
+        uint32_t missed = 0u;
+        RunningStat lat; // ns
+        std::vector<uint32_t> hist;
+    };
+    std::vector<Node> nodes; // [node]
+
+    std::string refName; // empty for host time
+    bool cycleOpen = false;
+    bool haveRef = false;
+    epicsTimeStamp refTs;
+    epicsTimeStamp tLast; // of last completed measurement
+    uint32_t nCycles = 0u;
+
+    ShardScan onChange; // on the shard of the first attached EventLog
+    unsigned changing=0u;
+
+    struct Observer : public EventLogObserver {
+        LinkProbe* const probe;
+        const size_t node; // or -1 for reference
+        Observer(LinkProbe* probe, size_t node) :probe(probe), node(node) {}
+        virtual ~Observer() {}
+        virtual void onEvents(const EventRec* recs, size_t nrecs) override final
+        {
+            Guard G(probe->lock);
+            for(size_t i=0u; i<nrecs; i++) {
+                if(!probe->code || recs[i].code!=probe->code)
+                    continue;
+                if(node==size_t(-1))
+                    probe->reference(recs[i].ts, false);
+                else
+                    probe->arrive(node, recs[i].ts);
+            }
+        }
+    };
+
+    LinkProbe()
+    {
+        refTs.secPastEpoch = refTs.nsec = 0u;
+        tLast = refTs;
+        shardScanInit(onChange, nullptr, onChangeComplete, this);
+    }
+
+    static
+    LinkProbe* getCreate(const std::string& name) {
+        Guard G(probesLock);
+        auto& ent = probes[name];
+        if(!ent)
+            ent.reset(new LinkProbe);
+        return ent.get();
+    }
+
+    // must lock
+    void changed()
+    {
+        if(!changing)
+            changing = shardScanRequest(onChange);
+    }
+
+    // must lock
+    void accumulate(Node& node)
+    {
+        double lat = diffNS(node.ts, refTs);
+
+        node.lat.add(lat);
+
+        if(node.hist.size()!=nbins)
+            node.hist.assign(nbins, 0u);
+        int64_t bin = (int64_t(lat) - histMin)*int64_t(nbins)/(histMax - histMin);
+        bin = std::max(int64_t(0), std::min(bin, int64_t(nbins)-1));
+        node.hist[bin]++;
+
+        tLast = node.ts;
+    }
+
+    // must lock
+    void openCycle()
+    {
+        if(cycleOpen) {
+            for(auto& node : nodes) {
+                if(!node.seen && !node.logName.empty())
+                    node.missed++;
+            }
+        }
+        for(auto& node : nodes) {
+            node.seen = node.early;
+            if(node.early)
+                node.ts = node.earlyTs;
+            node.early = false;
+        }
+        cycleOpen = true;
+        haveRef = false;
+        nCycles++;
+        changed();
+    }
+
+    // must lock.  fired=true from host, before the probe is sent
+    void reference(const epicsTimeStamp& ts, bool fired)
+    {
+        if(fired) {
+            openCycle();
+            if(!refName.empty())
+                return; // wait for reference log
+        } else if(refName.empty()) {
+            return; // host time reference only
+        } else if(!cycleOpen || haveRef) {
+            openCycle(); // not fired by us, eg. sequencer
+        }
+
+        haveRef = true;
+        refTs = ts;
+
+        // nodes which saw the probe before the reference
+        for(auto& node : nodes) {
+            if(!node.seen) {
+            } else if(!refName.empty() && llabs(diffNS(node.ts, refTs)) > window) {
+                node.seen = false; // not this probe.  will count as missed
+            } else {
+                accumulate(node);
+            }
+        }
+        changed();
+    }
+
+    // must lock
+    void arrive(size_t idx, const epicsTimeStamp& ts)
+    {
+        auto& node = nodes[idx];
+        if(!cycleOpen)
+            return; // not ours
+
+        if(!refName.empty() && haveRef
+                && (node.seen || llabs(diffNS(ts, refTs)) > window))
+        {
+            // probe of the next cycle, before its reference
+            node.early = true;
+            node.earlyTs = ts;
+            return;
+        }
+
+        if(node.seen)
+            return; // duplicate
+
+        node.seen = true;
+        node.ts = ts;
+        if(haveRef) {
+            accumulate(node);
+            changed();
+        }
+    }
+
+    static
+    void onChangeComplete(void *usr, IOSCANPVT, int prio) noexcept
+    {
+        auto self=static_cast<LinkProbe*>(usr);
+        try {
+            unsigned mask = 1u<<prio;
+            Guard G(self->lock);
+            assert(self->changing & mask);
+            self->changing &= ~mask;
+
+        }catch(std::exception& e){
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", __func__, e.what());
+        }
+    }
+};
+
+struct ProbeDev {
+    LinkProbe* const probe;
+    long node = -1;
+
+    enum stat_t {
+        Last, Mean, Std, Min, Max, Count, Missed, Bins,
+    } stat = Last;
+
+    explicit ProbeDev(LinkProbe* probe)
+        :probe(probe)
+    {}
+};
+
+long probeInitRecord(dbCommon *prec) noexcept {
+    try {
+        auto plink(dbGetDevLink(prec));
+        assert(plink->type==INST_IO);
+        std::string lstr(plink->value.instio.string);
+
+        std::string probeName, logName, refName;
+        int code = -1;
+        long node = -1;
+        int64_t histMin = 0, histMax = 0;
+        size_t nbins = 0u;
+        int64_t window = 0;
+        ProbeDev::stat_t stat = ProbeDev::Last;
+
+        char *saved = nullptr;
+        for(char* word = epicsStrtok_r((char*)lstr.data(), " ", &saved)
+             ; word
+             ; word = epicsStrtok_r(NULL, " ", &saved))
+        {
+            auto wlen = strlen(word);
+
+            auto cmd = [=](const char *pref) -> const char* {
+                auto plen = strlen(pref);
+                if(wlen >= plen && memcmp(word, pref, plen)==0) {
+                    return word + plen;
+                }
+                return nullptr;
+            };
+
+            if(auto val = cmd("probe=")) {
+                probeName = val;
+
+            } else if(auto val = cmd("code=")) {
+                code = std::stoi(val, nullptr, 0);
+                if(code<1 || code>255)
+                    throw std::runtime_error("code= must be 1-255");
+
+            } else if(auto val = cmd("ref=")) {
+                refName = val;
+
+            } else if(auto val = cmd("node=")) {
+                node = std::stol(val, nullptr, 0);
+                if(node<0 || node>=1024)
+                    throw std::runtime_error("node= must be 0-1023");
+
+            } else if(auto val = cmd("log=")) {
+                logName = val;
+
+            } else if(auto val = cmd("min=")) {
+                histMin = std::stoll(val, nullptr, 0);
+
+            } else if(auto val = cmd("max=")) {
+                histMax = std::stoll(val, nullptr, 0);
+
+            } else if(auto val = cmd("window=")) {
+                window = std::stoll(val, nullptr, 0);
+                if(window<=0)
+                    throw std::runtime_error("window= must be >0");
+
+            } else if(auto val = cmd("bins=")) {
+                nbins = std::stoul(val, nullptr, 0);
+                if(!nbins)
+                    throw std::runtime_error("bins= must be >0");
+
+            } else if(auto val = cmd("stat=")) {
+                if(epicsStrCaseCmp(val, "last")==0) {
+                    stat = ProbeDev::Last;
+                } else if(epicsStrCaseCmp(val, "mean")==0) {
+                    stat = ProbeDev::Mean;
+                } else if(epicsStrCaseCmp(val, "std")==0) {
+                    stat = ProbeDev::Std;
+                } else if(epicsStrCaseCmp(val, "min")==0) {
+                    stat = ProbeDev::Min;
+                } else if(epicsStrCaseCmp(val, "max")==0) {
+                    stat = ProbeDev::Max;
+                } else if(epicsStrCaseCmp(val, "count")==0) {
+                    stat = ProbeDev::Count;
+                } else if(epicsStrCaseCmp(val, "missed")==0) {
+                    stat = ProbeDev::Missed;
+                } else if(epicsStrCaseCmp(val, "bins")==0) {
+                    stat = ProbeDev::Bins;
+                } else {
+                    throw std::runtime_error("stat= must be 'last', 'mean', 'std', 'min', 'max', 'count', 'missed', or 'bins'");
+                }
+
+            } else {
+                throw std::runtime_error("Unexpected dev. link parameter");
+            }
+        }
+
+        if(probeName.empty())
+            throw std::runtime_error("Missing probe=");
+        if(!logName.empty() && node<0)
+            throw std::runtime_error("log= requires node=");
+
+        auto probe = LinkProbe::getCreate(probeName);
+        bool attachNode = false, attachRef = false;
+        {
+            Guard G(probe->lock);
+
+            if(code>0) {
+                if(probe->code && probe->code!=code)
+                    throw std::runtime_error("probe= already has different code=");
+                probe->code = code;
+            }
+            if(histMin || histMax) {
+                if(histMax <= histMin)
+                    throw std::runtime_error("max= must be greater than min=");
+                probe->histMin = histMin;
+                probe->histMax = histMax;
+            }
+            if(nbins)
+                probe->nbins = nbins;
+            if(window)
+                probe->window = window;
+
+            if(!refName.empty()) {
+                if(probe->refName.empty()) {
+                    probe->refName = refName;
+                    attachRef = true;
+                } else if(probe->refName!=refName) {
+                    throw std::runtime_error("probe= already has different ref=");
+                }
+            }
+
+            if(node>=0) {
+                if(probe->nodes.size() <= size_t(node))
+                    probe->nodes.resize(node+1);
+                auto& ent = probe->nodes[node];
+                if(!logName.empty()) {
+                    if(ent.logName.empty()) {
+                        ent.logName = logName;
+                        attachNode = true;
+                    } else if(ent.logName!=logName) {
+                        throw std::runtime_error("node= already associated with different log=");
+                    }
+                }
+            }
+
+            if(attachRef)
+                shardScanAssign(probe->onChange, refName);
+            if(attachNode)
+                shardScanAssign(probe->onChange, logName);
+        }
+        // never free'd
+        if(attachRef)
+            eventLogAttach(refName, new LinkProbe::Observer(probe, size_t(-1)));
+        if(attachNode)
+            eventLogAttach(logName, new LinkProbe::Observer(probe, node));
+
+        auto pvt = new ProbeDev(probe);
+        pvt->node = node;
+        pvt->stat = stat;
+        prec->dpvt = (void*)pvt;
+
+        return 0;
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", prec->name, e.what());
+        return -1;
+    }
+}
+
+long probeChanged(int detach, struct dbCommon *prec, IOSCANPVT* pscan) noexcept
+{
+    (void)detach;
+    auto pvt = static_cast<ProbeDev*>(prec->dpvt);
+    if(!pvt)
+        return -1;
+
+    *pscan = pvt->probe->onChange.scan;
+    return 0;
+}
+
+#define TRY \
+    if(!prec->dpvt) { \
+            recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "No Init"); \
+            return -1; \
+    } \
+    auto pvt = static_cast<ProbeDev*>(prec->dpvt); \
+    try
+
+#define CATCH \
+    catch(std::exception& e){ \
+        recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "%s", e.what()); \
+        if(prec->tpro) \
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", prec->name, e.what()); \
+        return -1; \
+}
+
+long probeFire(longoutRecord *prec) noexcept
+{
+    TRY {
+        auto probe = pvt->probe;
+        Guard G(probe->lock);
+
+        if(!probe->code)
+            throw std::runtime_error("No code=");
+
+        epicsTimeStamp now;
+        if(epicsTimeGetCurrent(&now))
+            throw std::runtime_error("No host time");
+
+        probe->reference(now, true);
+
+        // for FLNK to EVG:swEvent
+        prec->val = probe->code;
+
+        return 0;
+    } CATCH
+}
+
+long probeStat(aaiRecord *prec) noexcept
+{
+    if(prec->ftvl!=menuFtypeDOUBLE) {
+        recGblSetSevrMsg(prec, READ_ALARM, INVALID_ALARM, "Bad FTVL");
+        return -1;
+    }
+
+    auto val = static_cast<double*>(prec->bptr);
+
+    TRY {
+        auto probe = pvt->probe;
+        Guard G(probe->lock);
+
+        epicsUInt32 n = 0u;
+        if(pvt->stat==ProbeDev::Bins) {
+            // bin centers
+            double width = double(probe->histMax - probe->histMin)/probe->nbins;
+            for(; n<prec->nelm && n<probe->nbins; n++)
+                val[n] = probe->histMin + (n+0.5)*width;
+
+        } else {
+            for(; n<prec->nelm && n<probe->nodes.size(); n++) {
+                auto& node = probe->nodes[n];
+                double v = epicsNAN;
+                switch(pvt->stat) {
+                case ProbeDev::Last: v = node.lat.value(RunningStat::Last); break;
+                case ProbeDev::Mean: v = node.lat.value(RunningStat::Mean); break;
+                case ProbeDev::Std: v = node.lat.value(RunningStat::Std); break;
+                case ProbeDev::Min: v = node.lat.value(RunningStat::Min); break;
+                case ProbeDev::Max: v = node.lat.value(RunningStat::Max); break;
+                case ProbeDev::Count: v = node.lat.value(RunningStat::Count); break;
+                case ProbeDev::Missed: v = node.missed; break;
+                case ProbeDev::Bins: break;
+                }
+                val[n] = v;
+            }
+        }
+        prec->nord = n;
+        prec->time = probe->tLast;
+
+        return 0;
+    } CATCH
+}
+
+long probeHist(aaiRecord *prec) noexcept
+{
+    if(prec->ftvl!=menuFtypeULONG) {
+        recGblSetSevrMsg(prec, READ_ALARM, INVALID_ALARM, "Bad FTVL");
+        return -1;
+    }
+
+    auto val = static_cast<epicsUInt32*>(prec->bptr);
+
+    TRY {
+        auto probe = pvt->probe;
+        Guard G(probe->lock);
+
+        if(pvt->node<0 || size_t(pvt->node)>=probe->nodes.size())
+            throw std::runtime_error("No node=");
+
+        auto& hist = probe->nodes[pvt->node].hist;
+        epicsUInt32 n = std::min(size_t(prec->nelm), hist.size());
+        std::copy(hist.begin(), hist.begin()+n, val);
+        prec->nord = n;
+        prec->time = probe->tLast;
+
+        return 0;
+    } CATCH
+}
+
+longoutdset devLinkProbeFire = {
+    {5, nullptr, nullptr, probeInitRecord, nullptr},
+    probeFire,
+};
+aaidset devLinkProbeStat = {
+    {5, nullptr, nullptr, probeInitRecord, probeChanged},
+    probeStat,
+};
+aaidset devLinkProbeHist = {
+    {5, nullptr, nullptr, probeInitRecord, probeChanged},
+    probeHist,
+};
+
+} // namespace
+
+extern "C" {
+epicsExportAddress(dset, devLinkProbeFire);
+epicsExportAddress(dset, devLinkProbeStat);
+epicsExportAddress(dset, devLinkProbeHist);
+}
@@ -0,0 +1,448 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* MPS first-fault history
+ *
+ * Observe an EventLog for MPS related event codes, and trigger an immediate
+ * read of MPS status.  Accumulate first-fault readbacks into a ring of
+ * trip records, newest first.
+ *
+ * Output:
+ *   - trigger (longin I/O Intr) on any of the event codes
+ *   - trip count (longin)
+ *   - history columns, inputs, sec, ns (aai)
+ */
+
+#include <map>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <deque>
+
+#include <stdint.h>
+#include <string.h>
+
+#define USE_TYPED_DRVET
+#define USE_TYPED_RSET
+#define USE_TYPED_DSET
+
+#include <epicsTypes.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsString.h>
+#include <epicsStdio.h>
+#include <epicsTime.h>
+#include <errlog.h>
+
+#include <alarm.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <devSup.h>
+#include <recGbl.h>
+#include <dbCommon.h>
+#include <aaiRecord.h>
+#include <longoutRecord.h>
+#include <longinRecord.h>
+#include <menuFtype.h>
+
+#include <epicsExport.h>
+
+#include "eventTable.h"
+#include "scanShard.h"
+
+namespace {
+using namespace ospreyTiming;
+
+typedef epicsGuard<epicsMutex> Guard;
+
+struct MpsHistory;
+
+epicsMutex historiesLock;
+std::map<std::string, std::unique_ptr<MpsHistory>> histories;
+
+struct MpsTrip {
+    epicsUInt32 inputs;
+    epicsTimeStamp ts; // of first fault
+};
+
+struct MpsHistory : public EventLogObserver {
+    epicsMutex lock;
+
+    std::string logName; // empty until attached
+    bool codes[256] = {}; // trigger codes
+    uint8_t lastCode = 0u;
+    // onTrigger and onChange on the shard of the EventLog, once attached
+    ShardScan onTrigger;
+    unsigned trigChanging=0u; // onTrigger scan priority mask in progress
+
+    size_t keep = 16u;
+    std::deque<MpsTrip> trips; // newest first
+    uint32_t nTrips = 0u;
+    ShardScan onChange;
+    unsigned changing=0u;
+
+    // first-fault readbacks not yet complete
+    epicsUInt32 pendInputs = 0u, pendSec = 0u;
+
+    MpsHistory()
+    {
+        shardScanInit(onTrigger, nullptr, onTriggerComplete, this);
+        shardScanInit(onChange, nullptr, onChangeComplete, this);
+    }
+    virtual ~MpsHistory() {}
+
+    static
+    MpsHistory* getCreate(const std::string& name) {
+        Guard G(historiesLock);
+        auto& ent = histories[name];
+        if(!ent)
+            ent.reset(new MpsHistory);
+        return ent.get();
+    }
+
+    virtual void onEvents(const EventRec* recs, size_t nrecs) override final
+    {
+        Guard G(lock);
+        bool trig = false;
+
+        for(size_t i=0u; i<nrecs; i++) {
+            if(codes[recs[i].code]) {
+                lastCode = recs[i].code;
+                trig = true;
+            }
+        }
+
+        if(trig && !trigChanging)
+            trigChanging = shardScanRequest(onTrigger);
+    }
+
+    // must lock
+    void append(epicsUInt32 ticks, double nsecPerTick)
+    {
+        MpsTrip trip;
+        trip.inputs = pendInputs;
+        trip.ts.secPastEpoch = pendSec - POSIX_TIME_AT_EPICS_EPOCH;
+        trip.ts.nsec = ticks*nsecPerTick + 0.5;
+
+        if(!trips.empty()) {
+            auto& prev = trips.front();
+            if(prev.inputs==trip.inputs
+                    && prev.ts.secPastEpoch==trip.ts.secPastEpoch
+                    && prev.ts.nsec==trip.ts.nsec)
+                return; // re-read of the same trip
+        }
+
+        trips.push_front(trip);
+        while(trips.size() > keep)
+            trips.pop_back();
+        nTrips++;
+
+        if(!changing)
+            changing = shardScanRequest(onChange);
+    }
+
+    static
+    void onTriggerComplete(void *usr, IOSCANPVT, int prio) noexcept
+    {
+        auto self=static_cast<MpsHistory*>(usr);
+        try {
+            unsigned mask = 1u<<prio;
+            Guard G(self->lock);
+            assert(self->trigChanging & mask);
+            self->trigChanging &= ~mask;
+
+        }catch(std::exception& e){
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", __func__, e.what());
+        }
+    }
+
+    static
+    void onChangeComplete(void *usr, IOSCANPVT, int prio) noexcept
+    {
+        auto self=static_cast<MpsHistory*>(usr);
+        try {
+            unsigned mask = 1u<<prio;
+            Guard G(self->lock);
+            assert(self->changing & mask);
+            self->changing &= ~mask;
+
+        }catch(std::exception& e){
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", __func__, e.what());
+        }
+    }
+};
+
+struct MpsDev {
+    dbCommon* const prec;
+    MpsHistory* const hist;
+
+    enum part_t {
+        Inputs, Sec, Ticks,
+    } part = Inputs;
+
+    MpsDev(dbCommon *prec, MpsHistory* hist)
+        :prec(prec), hist(hist)
+    {}
+};
+
+long mpsInitRecord(dbCommon *prec) noexcept {
+    try {
+        auto plink(dbGetDevLink(prec));
+        assert(plink->type==INST_IO);
+        std::string lstr(plink->value.instio.string);
+
+        std::string histName, logName, trig;
+        size_t keep = 0u;
+        MpsDev::part_t part = MpsDev::Inputs;
+
+        char *saved = nullptr;
+        for(char* word = epicsStrtok_r((char*)lstr.data(), " ", &saved)
+             ; word
+             ; word = epicsStrtok_r(NULL, " ", &saved))
+        {
+            auto wlen = strlen(word);
+
+            auto cmd = [=](const char *pref) -> const char* {
+                auto plen = strlen(pref);
+                if(wlen >= plen && memcmp(word, pref, plen)==0) {
+                    return word + plen;
+                }
+                return nullptr;
+            };
+
+            if(auto val = cmd("hist=")) {
+                histName = val;
+
+            } else if(auto val = cmd("log=")) {
+                logName = val;
+
+            } else if(auto val = cmd("trig=")) {
+                trig = val;
+
+            } else if(auto val = cmd("keep=")) {
+                keep = std::stoul(val, nullptr, 0);
+                if(!keep)
+                    throw std::runtime_error("keep= must be >0");
+
+            } else if(auto val = cmd("part=")) {
+                if(epicsStrCaseCmp(val, "inputs")==0) {
+                    part = MpsDev::Inputs;
+                } else if(epicsStrCaseCmp(val, "sec")==0) {
+                    part = MpsDev::Sec;
+                } else if(epicsStrCaseCmp(val, "ticks")==0 || epicsStrCaseCmp(val, "ns")==0) {
+                    part = MpsDev::Ticks; // ticks in, ns out
+                } else {
+                    throw std::runtime_error("part= must be 'inputs', 'sec', 'ticks', or 'ns'");
+                }
+
+            } else {
+                throw std::runtime_error("Unexpected dev. link parameter");
+            }
+        }
+
+        if(histName.empty())
+            throw std::runtime_error("Missing hist=");
+
+        auto hist = MpsHistory::getCreate(histName);
+        bool attach = false;
+        {
+            Guard G(hist->lock);
+
+            if(keep)
+                hist->keep = keep;
+
+            if(!logName.empty()) {
+                if(hist->logName.empty()) {
+                    hist->logName = logName;
+                    shardScanAssign(hist->onTrigger, logName);
+                    shardScanAssign(hist->onChange, logName);
+                    attach = true;
+                } else if(hist->logName!=logName) {
+                    throw std::runtime_error("hist= already associated with different log=");
+                }
+            }
+
+            // comma separated list of event codes
+            size_t pos = 0u;
+            while(pos < trig.size()) {
+                auto sep = trig.find_first_of(',', pos);
+                if(sep==std::string::npos)
+                    sep = trig.size();
+                auto code = std::stoi(trig.substr(pos, sep-pos), nullptr, 0);
+                if(code<1 || code>255)
+                    throw std::runtime_error("trig= must be event codes 1-255");
+                hist->codes[code] = true;
+                pos = sep+1u;
+            }
+        }
+        if(attach)
+            eventLogAttach(logName, hist);
+
+        auto pvt = new MpsDev(prec, hist);
+        pvt->part = part;
+        prec->dpvt = (void*)pvt;
+
+        return 0;
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", prec->name, e.what());
+        return -1;
+    }
+}
+
+long mpsTriggerChanged(int detach, struct dbCommon *prec, IOSCANPVT* pscan) noexcept
+{
+    (void)detach;
+    auto pvt = static_cast<MpsDev*>(prec->dpvt);
+    if(!pvt)
+        return -1;
+
+    *pscan = pvt->hist->onTrigger.scan;
+    return 0;
+}
+
+long mpsHistChanged(int detach, struct dbCommon *prec, IOSCANPVT* pscan) noexcept
+{
+    (void)detach;
+    auto pvt = static_cast<MpsDev*>(prec->dpvt);
+    if(!pvt)
+        return -1;
+
+    *pscan = pvt->hist->onChange.scan;
+    return 0;
+}
+
+#define TRY \
+    if(!prec->dpvt) { \
+            recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "No Init"); \
+            return -1; \
+    } \
+    auto pvt = static_cast<MpsDev*>(prec->dpvt); \
+    try
+
+#define CATCH \
+    catch(std::exception& e){ \
+        recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "%s", e.what()); \
+        if(prec->tpro) \
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", prec->name, e.what()); \
+        return -1; \
+}
+
+long mpsTrigger(longinRecord *prec) noexcept
+{
+    TRY {
+        auto hist = pvt->hist;
+        Guard G(hist->lock);
+
+        prec->val = hist->lastCode;
+
+        return 0;
+    } CATCH
+}
+
+long mpsAppend(longoutRecord *prec) noexcept
+{
+    TRY {
+        auto hist = pvt->hist;
+        std::string logName;
+        {
+            Guard G(hist->lock);
+
+            switch(pvt->part) {
+            case MpsDev::Inputs:
+                hist->pendInputs = prec->val;
+                return 0;
+            case MpsDev::Sec:
+                hist->pendSec = prec->val;
+                return 0;
+            case MpsDev::Ticks:
+                break;
+            }
+            logName = hist->logName;
+        }
+
+        // EventLog lock must not be taken while holding our lock
+        double nsecPerTick = logName.empty() ? 1.0 : eventLogNsecPerTick(logName);
+
+        Guard G(hist->lock);
+        hist->append(prec->val, nsecPerTick);
+
+        return 0;
+    } CATCH
+}
+
+long mpsCount(longinRecord *prec) noexcept
+{
+    TRY {
+        auto hist = pvt->hist;
+        Guard G(hist->lock);
+
+        prec->val = epicsInt32(hist->nTrips);
+        if(!hist->trips.empty())
+            prec->time = hist->trips.front().ts;
+
+        return 0;
+    } CATCH
+}
+
+long mpsHistory(aaiRecord *prec) noexcept
+{
+    if(prec->ftvl!=menuFtypeULONG) {
+        recGblSetSevrMsg(prec, READ_ALARM, INVALID_ALARM, "Bad FTVL");
+        return -1;
+    }
+
+    auto val = static_cast<epicsUInt32*>(prec->bptr);
+
+    TRY {
+        auto hist = pvt->hist;
+        Guard G(hist->lock);
+
+        epicsUInt32 n = 0u;
+        for(; n<prec->nelm && n<hist->trips.size(); n++) {
+            auto& trip = hist->trips[n];
+            switch(pvt->part) {
+            case MpsDev::Inputs:
+                val[n] = trip.inputs;
+                break;
+            case MpsDev::Sec:
+                val[n] = trip.ts.secPastEpoch + POSIX_TIME_AT_EPICS_EPOCH;
+                break;
+            case MpsDev::Ticks:
+                val[n] = trip.ts.nsec;
+                break;
+            }
+        }
+        prec->nord = n;
+        if(!hist->trips.empty())
+            prec->time = hist->trips.front().ts;
+
+        return 0;
+    } CATCH
+}
+
+longindset devMpsTripTrigger = {
+    {5, nullptr, nullptr, mpsInitRecord, mpsTriggerChanged},
+    mpsTrigger,
+};
+longoutdset devMpsTripAppend = {
+    {5, nullptr, nullptr, mpsInitRecord, nullptr},
+    mpsAppend,
+};
+longindset devMpsTripCount = {
+    {5, nullptr, nullptr, mpsInitRecord, mpsHistChanged},
+    mpsCount,
+};
+aaidset devMpsTripHistory = {
+    {5, nullptr, nullptr, mpsInitRecord, mpsHistChanged},
+    mpsHistory,
+};
+
+} // namespace
+
+extern "C" {
+epicsExportAddress(dset, devMpsTripTrigger);
+epicsExportAddress(dset, devMpsTripAppend);
+epicsExportAddress(dset, devMpsTripCount);
+epicsExportAddress(dset, devMpsTripHistory);
+}
@@ -0,0 +1,940 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* MPS self-test engine.  cf. scripts/mpsCheck.py
+ *
+ * Tests one MPS output on many nodes concurrently.  Each step is applied to
+ * all nodes as one batch of Channel Access puts, followed by a single settle
+ * delay, and a batch of readbacks.  So run time is independent of the number
+ * of nodes.
+ *
+ *   mpsSelfTestConfigure("NAME", "EVG:", "EVR:1: EVR:2:", 1, 8, 0.5)
+ *
+ * before iocInit.
+ *
+ * Output:
+ *   - pass/fail matrix, node major (aai)
+ *   - duration of each step (aai)
+ *   - failed step count per node (aai)
+ *   - state, current step, step count (longin)
+ */
+
+#include <map>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <sstream>
+
+#include <stdint.h>
+#include <string.h>
+
+#define USE_TYPED_DRVET
+#define USE_TYPED_RSET
+#define USE_TYPED_DSET
+
+#include <epicsTypes.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsEvent.h>
+#include <epicsThread.h>
+#include <epicsString.h>
+#include <epicsStdio.h>
+#include <epicsTime.h>
+#include <epicsMonotonic.h>
+#include <iocsh.h>
+#include <errlog.h>
+#include <cadef.h>
+
+#include <alarm.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <devSup.h>
+#include <recGbl.h>
+#include <dbCommon.h>
+#include <aaiRecord.h>
+#include <longoutRecord.h>
+#include <longinRecord.h>
+#include <menuFtype.h>
+
+#include <epicsExport.h>
+
+namespace {
+
+typedef epicsGuard<epicsMutex> Guard;
+typedef epicsGuardRelease<epicsMutex> UnGuard;
+
+struct MpsSelfTest;
+
+epicsMutex selfTestsLock;
+std::map<std::string, std::unique_ptr<MpsSelfTest>> selfTests;
+
+const epicsInt32 mpsClearEventCode = 126;
+
+enum result_t : epicsUInt32 {
+    NotRun = 0u,
+    Pass = 1u,
+    Fail = 2u,
+    Error = 3u, // CA disconnect, timeout, or put failure
+};
+
+struct Node;
+
+// one outstanding put or get
+struct Op {
+    MpsSelfTest* self;
+    Node* node;
+    chid ch;
+    epicsInt32 val;
+    epicsInt32* dest; // nullptr for put
+    bool done;
+};
+
+struct Node {
+    std::string prefix;
+    bool ok = true; // false after any CA error
+
+    chid invert = nullptr, goodState = nullptr, chkInputs = nullptr, forceTrip = nullptr;
+    chid status = nullptr, statusProc = nullptr;
+    chid firstInputs = nullptr, firstInputsProc = nullptr;
+    chid firstSeconds = nullptr, firstSecondsProc = nullptr;
+    chid firstTicks = nullptr, firstTicksProc = nullptr;
+
+    // restored after test
+    epicsInt32 saveInvert = 0, saveGoodState = 0, saveChkInputs = 0;
+    bool restoreNeeded = false; // save* valid, and not yet restored.  Kept across runs
+
+    epicsInt32 inverted = 0; // invert mask to make all inputs look low
+    epicsInt32 st = 0, fi = 0, fs = 0, ft = 0; // readbacks
+    epicsInt32 tripI = 0, tripS = 0, tripT = 0; // first trip of current input
+
+    std::vector<chid*> channels() {
+        return {&invert, &goodState, &chkInputs, &forceTrip,
+                &status, &statusProc,
+                &firstInputs, &firstInputsProc,
+                &firstSeconds, &firstSecondsProc,
+                &firstTicks, &firstTicksProc};
+    }
+    // needed by restore()
+    bool restorable() const {
+        for(auto ch : {invert, goodState, chkInputs, forceTrip}) {
+            if(!ch || ca_state(ch)!=cs_conn)
+                return false;
+        }
+        return true;
+    }
+};
+
+struct MpsSelfTest : public epicsThreadRunable {
+    // configuration, const after iocInit
+    std::string name;
+    std::string evgPrefix;
+    std::vector<std::string> nodePrefixes;
+    unsigned output = 1u;
+    unsigned ninputs = 8u;
+    double settle = 0.5; // sec.  after each batch of puts
+    double timeout = 5.0; // sec.  for connect, and each batch
+
+    epicsThread worker;
+    epicsEvent wakeup;
+
+    epicsMutex lock;
+    // published, guarded by lock
+    enum state_t : epicsInt32 {
+        Idle, Running, Passed, Failed,
+        RestoreFailed, // some node settings not restored.  see errlog
+    } state = Idle;
+    bool startReq = false;
+    bool stopReq = false;
+    size_t step = 0u;
+    std::vector<epicsUInt32> matrix; // [node*nsteps + step]
+    std::vector<double> stepTime; // [step] seconds
+    std::vector<epicsUInt32> nodeFails; // [node]
+    IOSCANPVT onChange;
+    unsigned changing = 0u;
+
+    // worker only, except 'pending' and Op::done guarded by lock
+    std::vector<Node> nodes;
+    chid swEvent = nullptr;
+    std::vector<Op> ops;
+    size_t pending = 0u;
+    epicsEvent opsDone;
+
+    explicit MpsSelfTest(const std::string& name)
+        :name(name)
+        ,worker(*this, ("MPSTST:"+name).c_str(),
+                epicsThreadGetStackSize(epicsThreadStackBig),
+                epicsThreadPriorityLow)
+    {
+        scanIoInit(&onChange);
+        scanIoSetComplete(onChange, onChangeComplete, this);
+    }
+    virtual ~MpsSelfTest() {}
+
+    size_t nsteps() const {
+        // cf. run()
+        return 2u + ninputs*(4u + 2u*ninputs);
+    }
+
+    static
+    void onChangeComplete(void *usr, IOSCANPVT, int prio) noexcept
+    {
+        auto self=static_cast<MpsSelfTest*>(usr);
+        try {
+            unsigned mask = 1u<<prio;
+            Guard G(self->lock);
+            assert(self->changing & mask);
+            self->changing &= ~mask;
+
+        }catch(std::exception& e){
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", __func__, e.what());
+        }
+    }
+
+    // must lock
+    void notify() {
+        if(!changing)
+            changing = scanIoRequest(onChange);
+    }
+
+    static
+    void opDone(struct event_handler_args args)
+    {
+        auto op = static_cast<Op*>(args.usr);
+        auto self = op->self;
+        Guard G(self->lock);
+        if(op->done)
+            return;
+        op->done = true;
+        if(args.status!=ECA_NORMAL) {
+            op->node->ok = false;
+        } else if(op->dest) {
+            *op->dest = *static_cast<const epicsInt32*>(args.dbr);
+        }
+        if(--self->pending==0u)
+            self->opsDone.trigger();
+    }
+
+    /* Issue all queued operations, and wait for completion.
+     * Nodes with incomplete operations are marked as failed.
+     */
+    void flush()
+    {
+        {
+            Guard G(lock);
+            pending = ops.size();
+        }
+        for(size_t i=0u; i<ops.size(); i++) {
+            auto& op = ops[i];
+            int err;
+            if(op.dest) {
+                err = ca_array_get_callback(DBR_LONG, 1, op.ch, opDone, &op);
+            } else {
+                err = ca_array_put_callback(DBR_LONG, 1, op.ch, &op.val, opDone, &op);
+            }
+            if(err!=ECA_NORMAL) {
+                Guard G(lock);
+                op.done = true;
+                op.node->ok = false;
+                pending--;
+            }
+        }
+        ca_flush_io();
+
+        bool timeout = false;
+        {
+            Guard G(lock);
+            while(pending && !timeout) {
+                UnGuard U(G);
+                timeout = !opsDone.wait(this->timeout);
+            }
+            if(timeout) {
+                for(auto& op : ops) {
+                    if(!op.done) {
+                        op.done = true; // ignore late completion
+                        op.node->ok = false;
+                    }
+                }
+            }
+        }
+        if(timeout) {
+            // cancels any outstanding callbacks for these nodes
+            for(auto& node : nodes) {
+                if(!node.ok)
+                    disconnect(node);
+            }
+        }
+
+        ops.clear();
+    }
+
+    // queue a put, issued by flush()
+    void put(Node& node, chid ch, epicsInt32 val)
+    {
+        if(!node.ok || !ch)
+            return;
+        ops.push_back(Op{this, &node, ch, val, nullptr, false});
+    }
+    // queue a get, issued by flush()
+    void get(Node& node, chid ch, epicsInt32* dest)
+    {
+        if(!node.ok || !ch)
+            return;
+        ops.push_back(Op{this, &node, ch, 0, dest, false});
+    }
+
+    void disconnect(Node& node)
+    {
+        for(auto pch : node.channels()) {
+            if(*pch) {
+                ca_clear_channel(*pch);
+                *pch = nullptr;
+            }
+        }
+    }
+
+    void connectNode(Node& node)
+    {
+        auto O(std::to_string(output));
+        auto& P = node.prefix;
+        auto create = [&P](const std::string& suffix, chid* pch) {
+            if(ca_create_channel((P+suffix).c_str(), nullptr, nullptr, CA_PRIORITY_DEFAULT, pch)!=ECA_NORMAL)
+                *pch = nullptr;
+        };
+        create("MPS:invert", &node.invert);
+        create("MPS:goodState:"+O, &node.goodState);
+        create("MPS:chkInputs:"+O, &node.chkInputs);
+        create("MPS:forceTrip", &node.forceTrip);
+        create("MPS:status:"+O, &node.status);
+        create("MPS:status:"+O+".PROC", &node.statusProc);
+        create("MPS:firstInputs:"+O, &node.firstInputs);
+        create("MPS:firstInputs:"+O+".PROC", &node.firstInputsProc);
+        create("MPS:firstSeconds:"+O, &node.firstSeconds);
+        create("MPS:firstSeconds:"+O+".PROC", &node.firstSecondsProc);
+        create("MPS:firstTicks:"+O, &node.firstTicks);
+        create("MPS:firstTicks:"+O+".PROC", &node.firstTicksProc);
+    }
+
+    void connect()
+    {
+        std::vector<Node> prev;
+        prev.swap(nodes);
+        nodes.resize(nodePrefixes.size());
+
+        for(size_t i=0u; i<nodes.size(); i++) {
+            auto& node = nodes[i];
+            node.prefix = nodePrefixes[i];
+            if(i<prev.size() && prev[i].restoreNeeded) {
+                // a previous restore() failed.  keep the original settings
+                node.saveInvert = prev[i].saveInvert;
+                node.saveGoodState = prev[i].saveGoodState;
+                node.saveChkInputs = prev[i].saveChkInputs;
+                node.restoreNeeded = true;
+            }
+            connectNode(node);
+        }
+        if(ca_create_channel((evgPrefix+"EVG:swEvent").c_str(), nullptr, nullptr, CA_PRIORITY_DEFAULT, &swEvent)!=ECA_NORMAL)
+            swEvent = nullptr;
+
+        // wait for all connections concurrently
+        (void)ca_pend_io(timeout);
+
+        for(auto& node : nodes) {
+            for(auto pch : node.channels()) {
+                if(!*pch || ca_state(*pch)!=cs_conn)
+                    node.ok = false;
+            }
+            if(!node.ok)
+                disconnect(node);
+        }
+    }
+
+    void clearChannels()
+    {
+        for(auto& node : nodes)
+            disconnect(node);
+        if(swEvent) {
+            ca_clear_channel(swEvent);
+            swEvent = nullptr;
+        }
+    }
+
+    // issue MPS clear event from EVG
+    void clearTrips()
+    {
+        if(!swEvent || ca_state(swEvent)!=cs_conn)
+            throw std::runtime_error("EVG:swEvent not connected");
+        if(ca_array_put(DBR_LONG, 1, swEvent, &mpsClearEventCode)!=ECA_NORMAL)
+            throw std::runtime_error("EVG:swEvent put failed");
+        ca_flush_io();
+    }
+
+    // read back status, and optionally first-fault
+    void readStatus(bool first)
+    {
+        for(auto& node : nodes) {
+            put(node, node.statusProc, 1);
+            if(first) {
+                put(node, node.firstInputsProc, 1);
+                put(node, node.firstSecondsProc, 1);
+                put(node, node.firstTicksProc, 1);
+            }
+        }
+        flush();
+
+        for(auto& node : nodes) {
+            get(node, node.status, &node.st);
+            if(first) {
+                get(node, node.firstInputs, &node.fi);
+                get(node, node.firstSeconds, &node.fs);
+                get(node, node.firstTicks, &node.ft);
+            }
+        }
+        flush();
+    }
+
+    /* Apply puts from 'apply' to all nodes, optionally clear trips, settle,
+     * then read back and evaluate 'check' for each node.
+     */
+    template<typename Apply, typename Check>
+    void runStep(bool clear, bool first, Apply apply, Check check)
+    {
+        auto start = epicsMonotonicGet();
+        {
+            Guard G(lock);
+            if(stopReq)
+                throw std::runtime_error("Aborted");
+        }
+
+        for(auto& node : nodes)
+            apply(node);
+        flush();
+
+        if(clear)
+            clearTrips();
+
+        epicsThreadSleep(settle);
+
+        readStatus(first);
+
+        auto nstep = nsteps();
+        Guard G(lock);
+        for(size_t n=0u; n<nodes.size(); n++) {
+            auto& node = nodes[n];
+            epicsUInt32 result;
+            if(!node.ok) {
+                result = Error;
+            } else if(check(node)) {
+                result = Pass;
+            } else {
+                result = Fail;
+            }
+            if(result!=Pass)
+                nodeFails[n]++;
+            matrix[n*nstep + step] = result;
+        }
+        stepTime[step] = (epicsMonotonicGet() - start)*1e-9;
+        step++;
+        notify();
+    }
+
+    void run() override final
+    {
+        ca_context_create(ca_enable_preemptive_callback);
+
+        while(true) {
+            wakeup.wait();
+            {
+                Guard G(lock);
+                if(!startReq)
+                    continue;
+                startReq = stopReq = false;
+                state = Running;
+                step = 0u;
+                auto nstep = nsteps();
+                matrix.assign(nodePrefixes.size()*nstep, NotRun);
+                stepTime.assign(nstep, 0.0);
+                nodeFails.assign(nodePrefixes.size(), 0u);
+                notify();
+            }
+
+            bool ok = false;
+            try {
+                connect();
+                test();
+                ok = true;
+                for(auto& node : nodes)
+                    ok &= node.ok;
+                {
+                    Guard G(lock);
+                    for(auto nf : nodeFails)
+                        ok &= !nf;
+                }
+            } catch(std::exception& e) {
+                errlogPrintf("%s: " ERL_ERROR ": %s\n", name.c_str(), e.what());
+            }
+
+            bool restored = false;
+            try {
+                restored = restore();
+            } catch(std::exception& e) {
+                errlogPrintf("%s: " ERL_ERROR " restoring: %s\n", name.c_str(), e.what());
+            }
+            clearChannels();
+
+            Guard G(lock);
+            state = !restored ? RestoreFailed : ok ? Passed : Failed;
+            notify();
+        }
+    }
+
+    /* Put back saved settings of every node which was changed, including
+     * nodes which failed during the test.  Returns false if any could not
+     * be restored.
+     */
+    bool restore()
+    {
+        bool reconnect = false;
+        for(auto& node : nodes) {
+            if(node.restoreNeeded && !(node.ok && node.restorable())) {
+                disconnect(node);
+                node.ok = true;
+                connectNode(node);
+                reconnect = true;
+            }
+        }
+        if(reconnect)
+            (void)ca_pend_io(timeout);
+
+        for(auto& node : nodes) {
+            if(!node.restoreNeeded)
+                continue;
+            if(!node.restorable()) {
+                node.ok = false;
+                continue;
+            }
+            put(node, node.forceTrip, 0);
+            put(node, node.invert, node.saveInvert);
+            put(node, node.goodState, node.saveGoodState);
+            put(node, node.chkInputs, node.saveChkInputs);
+        }
+        flush();
+
+        bool restored = true;
+        for(auto& node : nodes) {
+            if(!node.restoreNeeded)
+                continue;
+            if(node.ok) {
+                node.restoreNeeded = false;
+            } else {
+                restored = false;
+                errlogPrintf("%s: " ERL_ERROR " %s NOT restored!  Force trip may be set.  "
+                             "Saved invert=0x%x goodState=0x%x chkInputs=0x%x\n",
+                             name.c_str(), node.prefix.c_str(),
+                             unsigned(node.saveInvert), unsigned(node.saveGoodState),
+                             unsigned(node.saveChkInputs));
+            }
+        }
+        return restored;
+    }
+
+    void test()
+    {
+        const epicsInt32 outputBit = 1<<(output-1u);
+        const epicsInt32 inputMask = (1<<ninputs)-1;
+
+        {
+            // stash for later restore, unless still held from a failed restore
+            for(auto& node : nodes) {
+                if(node.restoreNeeded)
+                    continue;
+                get(node, node.invert, &node.saveInvert);
+                get(node, node.goodState, &node.saveGoodState);
+                get(node, node.chkInputs, &node.saveChkInputs);
+            }
+            flush();
+            for(auto& node : nodes) {
+                if(node.ok)
+                    node.restoreNeeded = true;
+            }
+        }
+
+        // force trip has the desired result
+        runStep(false, false, [outputBit, this](Node& node) {
+            put(node, node.forceTrip, outputBit);
+        }, [](Node& node) {
+            return epicsUInt32(node.st)==0x80000003u;
+        });
+
+        // forced trip can be cleared
+        runStep(true, false, [this](Node& node) {
+            put(node, node.forceTrip, 0);
+        }, [](Node& node) {
+            return node.st==0;
+        });
+
+        for(unsigned inp=0u; inp<ninputs; inp++) {
+            const epicsInt32 inputBit = 1<<inp;
+
+            // prepare.  check all inputs, then read current input state
+            {
+                for(auto& node : nodes)
+                    put(node, node.chkInputs, inputMask);
+                flush();
+
+                for(auto& node : nodes) {
+                    get(node, node.invert, &node.inverted);
+                    get(node, node.status, &node.st);
+                }
+                flush();
+            }
+
+            // make all inputs look low, important, good state 0, and clear
+            runStep(true, false, [inputMask, this](Node& node) {
+                node.inverted ^= (node.st>>16) & inputMask;
+                put(node, node.invert, node.inverted);
+                put(node, node.goodState, 0);
+                put(node, node.chkInputs, inputMask);
+            }, [](Node& node) {
+                return node.st==0;
+            });
+
+            // important input going bad causes a trip
+            runStep(false, true, [inputBit, this](Node& node) {
+                put(node, node.invert, node.inverted ^ inputBit);
+            }, [inputBit](Node& node) {
+                return node.st==((inputBit<<16)|0x3) && node.fi==inputBit;
+            });
+
+            // input going good removes fault but not the trip
+            runStep(false, true, [this](Node& node) {
+                put(node, node.invert, node.inverted);
+            }, [inputBit](Node& node) {
+                node.tripI = node.fi;
+                node.tripS = node.fs;
+                node.tripT = node.ft;
+                return node.st==0x1 && node.fi==inputBit;
+            });
+
+            // other inputs going bad cause fault, but leave first fault unchanged
+            for(unsigned i=0u; i<ninputs; i++) {
+                const epicsInt32 b = 1<<i;
+                auto same = [](Node& node) {
+                    return node.fi==node.tripI && node.fs==node.tripS && node.ft==node.tripT;
+                };
+
+                runStep(false, true, [b, this](Node& node) {
+                    put(node, node.invert, node.inverted ^ b);
+                }, [b, same](Node& node) {
+                    return node.st==((b<<16)|0x3) && same(node);
+                });
+
+                runStep(false, true, [this](Node& node) {
+                    put(node, node.invert, node.inverted);
+                }, [same](Node& node) {
+                    return node.st==0x1 && same(node);
+                });
+            }
+
+            // trip clear has the desired effect
+            runStep(true, false, [](Node&) {
+            }, [](Node& node) {
+                return node.st==0;
+            });
+        }
+    }
+};
+
+struct TestDev {
+    dbCommon* const prec;
+    MpsSelfTest* const test;
+
+    enum stat_t {
+        State, Step, NSteps, NFail,
+    } stat = State;
+    enum col_t {
+        Matrix, Time, Node,
+    } col = Matrix;
+
+    TestDev(dbCommon *prec, MpsSelfTest* test)
+        :prec(prec), test(test)
+    {}
+};
+
+long selfTestInitRecord(dbCommon *prec) noexcept {
+    try {
+        auto plink(dbGetDevLink(prec));
+        assert(plink->type==INST_IO);
+        std::string lstr(plink->value.instio.string);
+
+        std::string testName;
+        TestDev::stat_t stat = TestDev::State;
+        TestDev::col_t col = TestDev::Matrix;
+
+        char *saved = nullptr;
+        for(char* word = epicsStrtok_r((char*)lstr.data(), " ", &saved)
+             ; word
+             ; word = epicsStrtok_r(NULL, " ", &saved))
+        {
+            auto wlen = strlen(word);
+
+            auto cmd = [=](const char *pref) -> const char* {
+                auto plen = strlen(pref);
+                if(wlen >= plen && memcmp(word, pref, plen)==0) {
+                    return word + plen;
+                }
+                return nullptr;
+            };
+
+            if(auto val = cmd("test=")) {
+                testName = val;
+
+            } else if(auto val = cmd("stat=")) {
+                if(epicsStrCaseCmp(val, "state")==0) {
+                    stat = TestDev::State;
+                } else if(epicsStrCaseCmp(val, "step")==0) {
+                    stat = TestDev::Step;
+                } else if(epicsStrCaseCmp(val, "nsteps")==0) {
+                    stat = TestDev::NSteps;
+                } else if(epicsStrCaseCmp(val, "nfail")==0) {
+                    stat = TestDev::NFail;
+                } else {
+                    throw std::runtime_error("stat= must be 'state', 'step', 'nsteps', or 'nfail'");
+                }
+
+            } else if(auto val = cmd("col=")) {
+                if(epicsStrCaseCmp(val, "matrix")==0) {
+                    col = TestDev::Matrix;
+                } else if(epicsStrCaseCmp(val, "time")==0) {
+                    col = TestDev::Time;
+                } else if(epicsStrCaseCmp(val, "node")==0) {
+                    col = TestDev::Node;
+                } else {
+                    throw std::runtime_error("col= must be 'matrix', 'time', or 'node'");
+                }
+
+            } else {
+                throw std::runtime_error("Unexpected dev. link parameter");
+            }
+        }
+
+        MpsSelfTest* test;
+        {
+            Guard G(selfTestsLock);
+            auto it = selfTests.find(testName);
+            if(it==selfTests.end())
+                throw std::runtime_error("No such test=, see mpsSelfTestConfigure()");
+            test = it->second.get();
+        }
+
+        auto pvt = new TestDev(prec, test);
+        pvt->stat = stat;
+        pvt->col = col;
+        prec->dpvt = (void*)pvt;
+
+        return 0;
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", prec->name, e.what());
+        return -1;
+    }
+}
+
+long selfTestChanged(int detach, struct dbCommon *prec, IOSCANPVT* pscan) noexcept
+{
+    (void)detach;
+    auto pvt = static_cast<TestDev*>(prec->dpvt);
+    if(!pvt)
+        return -1;
+
+    *pscan = pvt->test->onChange;
+    return 0;
+}
+
+#define TRY \
+    if(!prec->dpvt) { \
+            recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "No Init"); \
+            return -1; \
+    } \
+    auto pvt = static_cast<TestDev*>(prec->dpvt); \
+    try
+
+#define CATCH \
+    catch(std::exception& e){ \
+        recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "%s", e.what()); \
+        if(prec->tpro) \
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", prec->name, e.what()); \
+        return -1; \
+}
+
+long selfTestStart(longoutRecord *prec) noexcept
+{
+    TRY {
+        auto test = pvt->test;
+        Guard G(test->lock);
+
+        if(prec->val) {
+            if(test->state==MpsSelfTest::Running) {
+                recGblSetSevrMsg(prec, WRITE_ALARM, MINOR_ALARM, "Busy");
+                return 0;
+            }
+            test->startReq = true;
+            test->wakeup.trigger();
+
+        } else if(test->state==MpsSelfTest::Running) {
+            test->stopReq = true; // abort before next step
+        }
+
+        return 0;
+    } CATCH
+}
+
+long selfTestStatus(longinRecord *prec) noexcept
+{
+    TRY {
+        auto test = pvt->test;
+        Guard G(test->lock);
+
+        switch(pvt->stat) {
+        case TestDev::State:
+            prec->val = test->state;
+            break;
+        case TestDev::Step:
+            prec->val = epicsInt32(test->step);
+            break;
+        case TestDev::NSteps:
+            prec->val = epicsInt32(test->nsteps());
+            break;
+        case TestDev::NFail: {
+            epicsInt32 n = 0;
+            for(auto nf : test->nodeFails)
+                n += nf ? 1 : 0;
+            prec->val = n;
+        }
+            break;
+        }
+
+        return 0;
+    } CATCH
+}
+
+long selfTestResult(aaiRecord *prec) noexcept
+{
+    TRY {
+        auto test = pvt->test;
+        Guard G(test->lock);
+
+        epicsUInt32 n = 0u;
+        if(pvt->col==TestDev::Time) {
+            if(prec->ftvl!=menuFtypeDOUBLE) {
+                recGblSetSevrMsg(prec, READ_ALARM, INVALID_ALARM, "Bad FTVL");
+                return -1;
+            }
+            auto val = static_cast<double*>(prec->bptr);
+            for(; n<prec->nelm && n<test->stepTime.size(); n++)
+                val[n] = test->stepTime[n];
+
+        } else {
+            if(prec->ftvl!=menuFtypeULONG) {
+                recGblSetSevrMsg(prec, READ_ALARM, INVALID_ALARM, "Bad FTVL");
+                return -1;
+            }
+            auto val = static_cast<epicsUInt32*>(prec->bptr);
+            auto& src = pvt->col==TestDev::Matrix ? test->matrix : test->nodeFails;
+            for(; n<prec->nelm && n<src.size(); n++)
+                val[n] = src[n];
+        }
+        prec->nord = n;
+
+        return 0;
+    } CATCH
+}
+
+longoutdset devMpsSelfTestStart = {
+    {5, nullptr, nullptr, selfTestInitRecord, nullptr},
+    selfTestStart,
+};
+longindset devMpsSelfTestStatus = {
+    {5, nullptr, nullptr, selfTestInitRecord, selfTestChanged},
+    selfTestStatus,
+};
+aaidset devMpsSelfTestResult = {
+    {5, nullptr, nullptr, selfTestInitRecord, selfTestChanged},
+    selfTestResult,
+};
+
+void mpsSelfTestConfigure(const char *name, const char *evg, const char *nodeList,
+                          int output, int ninputs, double settle)
+{
+    try {
+        if(!name || !name[0])
+            throw std::runtime_error("Missing name");
+        if(!evg)
+            evg = "";
+        if(!nodeList)
+            nodeList = "";
+        if(output<1 || output>8)
+            throw std::runtime_error("output must be 1-8");
+        if(ninputs<1 || ninputs>8)
+            throw std::runtime_error("inputs must be 1-8");
+
+        std::unique_ptr<MpsSelfTest> test(new MpsSelfTest(name));
+        test->evgPrefix = evg;
+        test->output = output;
+        test->ninputs = ninputs;
+        if(settle>0.0)
+            test->settle = settle;
+
+        std::istringstream strm(nodeList);
+        std::string prefix;
+        while(strm>>prefix)
+            test->nodePrefixes.push_back(prefix);
+
+        if(test->nodePrefixes.empty())
+            throw std::runtime_error("Empty node list");
+
+        Guard G(selfTestsLock);
+        auto& ent = selfTests[name];
+        if(ent)
+            throw std::runtime_error("Duplicate name");
+        ent = std::move(test);
+        ent->worker.start();
+
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", __func__, e.what());
+    }
+}
+
+const iocshArg mpsSelfTestConfigureArg0 = {"name", iocshArgString};
+const iocshArg mpsSelfTestConfigureArg1 = {"EVG prefix", iocshArgString};
+const iocshArg mpsSelfTestConfigureArg2 = {"node prefixes", iocshArgString};
+const iocshArg mpsSelfTestConfigureArg3 = {"output", iocshArgInt};
+const iocshArg mpsSelfTestConfigureArg4 = {"inputs", iocshArgInt};
+const iocshArg mpsSelfTestConfigureArg5 = {"settle", iocshArgDouble};
+const iocshArg * const mpsSelfTestConfigureArgs[] = {
+    &mpsSelfTestConfigureArg0, &mpsSelfTestConfigureArg1, &mpsSelfTestConfigureArg2,
+    &mpsSelfTestConfigureArg3, &mpsSelfTestConfigureArg4, &mpsSelfTestConfigureArg5,
+};
+const iocshFuncDef mpsSelfTestConfigureDef = {"mpsSelfTestConfigure", 6, mpsSelfTestConfigureArgs,
+                                              "Configure MPS self-test of one output on a list of nodes.\n"
+                                              "Node prefixes are space separated.  Settle time in seconds, default 0.5.\n"};
+
+void mpsSelfTestConfigureCall(const iocshArgBuf *args)
+{
+    mpsSelfTestConfigure(args[0].sval, args[1].sval, args[2].sval,
+                         args[3].ival, args[4].ival, args[5].dval);
+}
+
+void mpsSelfTestRegistrar()
+{
+    iocshRegister(&mpsSelfTestConfigureDef, mpsSelfTestConfigureCall);
+}
+
+} // namespace
+
+extern "C" {
+epicsExportAddress(dset, devMpsSelfTestStart);
+epicsExportAddress(dset, devMpsSelfTestStatus);
+epicsExportAddress(dset, devMpsSelfTestResult);
+epicsExportRegistrar(mpsSelfTestRegistrar);
+}
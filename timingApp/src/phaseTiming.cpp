@@ -0,0 +1,354 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* Phase timing of record chains
+ *
+ * Records placed at the boundaries of a chain, eg. the on connect
+ * initialization of an FPGA, mark the start and the end of each phase
+ * with the monotonic clock.
+ *
+ *   start -> phase 1 -> phase 2 -> ... -> phase N (last)
+ *
+ * Marks outside of start...last are ignored.  So records in the chain
+ * may also process at other times.
+ *
+ * Output:
+ *   - per phase and total duration, historical max, and count (ai)
+ */
+
+#include <map>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <stdint.h>
+#include <string.h>
+
+#define USE_TYPED_RSET
+#define USE_TYPED_DSET
+
+#include <epicsTypes.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsString.h>
+#include <epicsStdio.h>
+#include <epicsMonotonic.h>
+#include <errlog.h>
+
+#include <alarm.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <devSup.h>
+#include <recGbl.h>
+#include <dbCommon.h>
+#include <aiRecord.h>
+#include <longoutRecord.h>
+
+#include <epicsExport.h>
+
+#include "scanShard.h"
+
+namespace {
+using namespace ospreyTiming;
+
+typedef epicsGuard<epicsMutex> Guard;
+
+struct PhaseTimer;
+
+epicsMutex timersLock;
+std::map<std::string, std::unique_ptr<PhaseTimer>> timers;
+
+struct PhaseTimer {
+    epicsMutex lock;
+
+    struct Phase {
+        double last = 0.0, max = 0.0; // seconds
+    };
+    std::vector<Phase> phases; // [N-1]
+    Phase total;
+    uint32_t count = 0u; // completed
+
+    bool running = false;
+    uint64_t tStart = 0u, tMark = 0u;
+
+    ShardScan onUpdate; // on the shard of the timer name
+    unsigned changing=0u;
+
+    explicit
+    PhaseTimer(const std::string& name)
+    {
+        shardScanInit(onUpdate, scanShardFor(name), onUpdateComplete, this);
+    }
+
+    static
+    PhaseTimer* getCreate(const std::string& name) {
+        Guard G(timersLock);
+        auto& ent = timers[name];
+        if(!ent)
+            ent.reset(new PhaseTimer(name));
+        return ent.get();
+    }
+
+    // must lock
+    void update()
+    {
+        if(!changing)
+            changing = shardScanRequest(onUpdate);
+    }
+
+    static
+    void onUpdateComplete(void *usr, IOSCANPVT, int prio) noexcept
+    {
+        auto self=static_cast<PhaseTimer*>(usr);
+        try {
+            unsigned mask = 1u<<prio;
+            Guard G(self->lock);
+            assert(self->changing & mask);
+            self->changing &= ~mask;
+
+        }catch(std::exception& e){
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", __func__, e.what());
+        }
+    }
+};
+
+struct PhaseDev {
+    PhaseTimer* const timer;
+
+    enum mark_t {
+        Start, End, Last, Reset,
+    } mark = End;
+    size_t phase = 0u; // 0 for total
+
+    enum stat_t {
+        Time, Max, Count,
+    } stat = Time;
+
+    explicit PhaseDev(PhaseTimer* timer)
+        :timer(timer)
+    {}
+};
+
+PhaseDev* parseLink(dbCommon *prec, bool output)
+{
+    auto plink(dbGetDevLink(prec));
+    assert(plink->type==INST_IO);
+    std::string lstr(plink->value.instio.string);
+
+    std::string timerName;
+    long phase = -1;
+    PhaseDev::mark_t mark = PhaseDev::End;
+    PhaseDev::stat_t stat = PhaseDev::Time;
+
+    char *saved = nullptr;
+    for(char* word = epicsStrtok_r((char*)lstr.data(), " ", &saved)
+         ; word
+         ; word = epicsStrtok_r(NULL, " ", &saved))
+    {
+        auto wlen = strlen(word);
+
+        auto cmd = [=](const char *pref) -> const char* {
+            auto plen = strlen(pref);
+            if(wlen >= plen && memcmp(word, pref, plen)==0) {
+                return word + plen;
+            }
+            return nullptr;
+        };
+
+        if(auto val = cmd("timer=")) {
+            timerName = val;
+
+        } else if(auto val = cmd("phase=")) {
+            if(epicsStrCaseCmp(val, "total")==0) {
+                phase = 0;
+            } else {
+                phase = std::stol(val, nullptr, 0);
+                if(phase<1 || phase>64)
+                    throw std::runtime_error("phase= must be 1-64, or 'total'");
+            }
+
+        } else if(output && strcmp(word, "start")==0) {
+            mark = PhaseDev::Start;
+
+        } else if(output && strcmp(word, "last")==0) {
+            mark = PhaseDev::Last;
+
+        } else if(output && strcmp(word, "reset")==0) {
+            mark = PhaseDev::Reset;
+
+        } else if(auto val = cmd("stat=")) {
+            if(output) {
+                throw std::runtime_error("stat= not applicable");
+            } else if(epicsStrCaseCmp(val, "time")==0) {
+                stat = PhaseDev::Time;
+            } else if(epicsStrCaseCmp(val, "max")==0) {
+                stat = PhaseDev::Max;
+            } else if(epicsStrCaseCmp(val, "count")==0) {
+                stat = PhaseDev::Count;
+            } else {
+                throw std::runtime_error("stat= must be 'time', 'max', or 'count'");
+            }
+
+        } else {
+            throw std::runtime_error("Unexpected dev. link parameter");
+        }
+    }
+
+    if(timerName.empty())
+        throw std::runtime_error("Missing timer=");
+
+    if(output) {
+        if(mark==PhaseDev::Start || mark==PhaseDev::Reset) {
+            if(phase>=0)
+                throw std::runtime_error("phase= not applicable");
+            phase = 0;
+        } else if(phase<1) {
+            throw std::runtime_error("Missing phase=");
+        }
+    } else if(phase<0) {
+        throw std::runtime_error("Missing phase=");
+    }
+
+    auto timer = PhaseTimer::getCreate(timerName);
+    {
+        Guard G(timer->lock);
+        if(timer->phases.size() < size_t(phase))
+            timer->phases.resize(phase);
+    }
+
+    std::unique_ptr<PhaseDev> pvt(new PhaseDev(timer));
+    pvt->mark = mark;
+    pvt->phase = phase;
+    pvt->stat = stat;
+    return pvt.release();
+}
+
+long phaseMarkInitRecord(dbCommon *prec) noexcept {
+    try {
+        prec->dpvt = (void*)parseLink(prec, true);
+        return 0;
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", prec->name, e.what());
+        return -1;
+    }
+}
+
+long phaseTimeInitRecord(dbCommon *prec) noexcept {
+    try {
+        prec->dpvt = (void*)parseLink(prec, false);
+        return 0;
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", prec->name, e.what());
+        return -1;
+    }
+}
+
+long phaseTimeChanged(int detach, struct dbCommon *prec, IOSCANPVT* pscan) noexcept
+{
+    (void)detach;
+    auto pvt = static_cast<PhaseDev*>(prec->dpvt);
+    if(!pvt)
+        return -1;
+
+    *pscan = pvt->timer->onUpdate.scan;
+    return 0;
+}
+
+#define TRY \
+    if(!prec->dpvt) { \
+            recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "No Init"); \
+            return -1; \
+    } \
+    auto pvt = static_cast<PhaseDev*>(prec->dpvt); \
+    try
+
+#define CATCH \
+    catch(std::exception& e){ \
+        recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "%s", e.what()); \
+        if(prec->tpro) \
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", prec->name, e.what()); \
+        return -1; \
+}
+
+long phaseMark(longoutRecord *prec) noexcept
+{
+    TRY {
+        auto now = epicsMonotonicGet();
+        auto timer = pvt->timer;
+        Guard G(timer->lock);
+
+        auto accumulate = [](PhaseTimer::Phase& ph, double dT) {
+            ph.last = dT;
+            if(dT > ph.max)
+                ph.max = dT;
+        };
+
+        switch(pvt->mark) {
+        case PhaseDev::Start:
+            // an interrupted cycle is abandoned
+            timer->running = true;
+            timer->tStart = timer->tMark = now;
+            break;
+
+        case PhaseDev::End:
+        case PhaseDev::Last:
+            if(!timer->running)
+                break;
+            accumulate(timer->phases[pvt->phase-1u], (now - timer->tMark)*1e-9);
+            timer->tMark = now;
+
+            if(pvt->mark==PhaseDev::Last) {
+                accumulate(timer->total, (now - timer->tStart)*1e-9);
+                timer->count++;
+                timer->running = false;
+            }
+            timer->update();
+            break;
+
+        case PhaseDev::Reset:
+            for(auto& ph : timer->phases)
+                ph.max = 0.0;
+            timer->total.max = 0.0;
+            timer->update();
+            break;
+        }
+
+        return 0;
+    } CATCH
+}
+
+long phaseTime(aiRecord *prec) noexcept
+{
+    TRY {
+        auto timer = pvt->timer;
+        Guard G(timer->lock);
+
+        auto& ph = pvt->phase ? timer->phases[pvt->phase-1u] : timer->total;
+
+        switch(pvt->stat) {
+        case PhaseDev::Time: prec->val = ph.last; break;
+        case PhaseDev::Max: prec->val = ph.max; break;
+        case PhaseDev::Count: prec->val = timer->count; break;
+        }
+
+        return 2; // no conversion
+    } CATCH
+}
+
+longoutdset devPhaseMark = {
+    {5, nullptr, nullptr, phaseMarkInitRecord, nullptr},
+    phaseMark,
+};
+aidset devPhaseTime = {
+    {6, nullptr, nullptr, phaseTimeInitRecord, phaseTimeChanged},
+    phaseTime, nullptr,
+};
+
+} // namespace
+
+extern "C" {
+epicsExportAddress(dset, devPhaseMark);
+epicsExportAddress(dset, devPhaseTime);
+}
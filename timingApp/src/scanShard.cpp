@@ -0,0 +1,531 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* I/O Intr delivery through per-node worker threads
+ *
+ * By default, I/O Intr scans of all EventLogs and BitTables go through
+ * the shared callback queues.  So a burst of events from one node delays
+ * record processing for all others.  With a worker pool configured, each
+ * named EventLog/BitTable is assigned to one worker, which processes the
+ * records itself with scanIoImmediate().  This includes the records of
+ * observers attached to an EventLog, and its maxrate= flush timers.
+ * Trends and phase timers are assigned by their own names.
+ *
+ *   scanShardConfigure(4, 80, "2,3")   # 4 workers, priority 80, pinned to CPU 2 and 3
+ *   scanShardAssign("EVR1:LOG", 0)     # optional, default is round robin
+ *
+ * before iocInit.
+ *
+ * Output:
+ *   - per worker queue depth, high water mark, scan count, and latency (ai)
+ */
+
+#include <map>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include <sstream>
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __linux__
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+
+#define USE_TYPED_DRVET
+#define USE_TYPED_RSET
+#define USE_TYPED_DSET
+
+#include <epicsTypes.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsEvent.h>
+#include <epicsThread.h>
+#include <epicsString.h>
+#include <epicsStdio.h>
+#include <epicsMonotonic.h>
+#include <iocsh.h>
+#include <errlog.h>
+
+#include <alarm.h>
+#include <callback.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <devSup.h>
+#include <recGbl.h>
+#include <dbCommon.h>
+#include <aiRecord.h>
+
+#include <epicsExport.h>
+
+#include "scanShard.h"
+
+namespace ospreyTiming {
+
+typedef epicsGuard<epicsMutex> Guard;
+typedef epicsGuardRelease<epicsMutex> UnGuard;
+
+struct ScanShard : public epicsThreadRunable {
+    const unsigned index;
+    const int cpu; // -1 for any
+
+    epicsThread worker;
+    epicsEvent wakeup;
+
+    epicsMutex lock;
+    struct Job {
+        ShardScan *scan;
+        uint64_t mono; // time of request
+    };
+    std::deque<Job> queue;
+    std::vector<ShardTimer*> timers; // armed
+
+    // statistics, guarded by lock
+    size_t hwm = 0u;
+    uint64_t nScans = 0u;
+    uint64_t nCoalesced = 0u; // requests merged with one already queued
+    double lastLatency = 0.0, maxLatency = 0.0; // seconds from request until processing starts
+
+    ScanShard(unsigned index, unsigned prio, int cpu)
+        :index(index)
+        ,cpu(cpu)
+        ,worker(*this, ("SHARD" + std::to_string(index)).c_str(),
+                epicsThreadGetStackSize(epicsThreadStackBig),
+                prio)
+    {}
+    virtual ~ScanShard() {}
+
+    void request(ShardScan& scan)
+    {
+        bool wake;
+        {
+            Guard G(lock);
+            if(scan.pending) {
+                nCoalesced++;
+                return;
+            }
+            scan.pending = true;
+            wake = queue.empty();
+            queue.push_back(Job{&scan, epicsMonotonicGet()});
+            if(queue.size() > hwm)
+                hwm = queue.size();
+        }
+        if(wake)
+            wakeup.trigger();
+    }
+
+    void requestDelayed(ShardTimer& timer, double delay)
+    {
+        {
+            Guard G(lock);
+            timer.due = epicsMonotonicGet() + uint64_t(std::max(delay, 0.0)*1e9);
+            if(!timer.armed) {
+                timer.armed = true;
+                timers.push_back(&timer);
+            }
+        }
+        wakeup.trigger(); // recompute timeout
+    }
+
+    // must lock.  Returns an expired timer, or nullptr and the next due time (0 for none)
+    ShardTimer* expired(uint64_t& next)
+    {
+        auto now = epicsMonotonicGet();
+        next = 0u;
+        for(auto it(timers.begin()), end(timers.end()); it!=end; ++it) {
+            auto timer = *it;
+            if(timer->due <= now) {
+                timers.erase(it);
+                timer->armed = false;
+                return timer;
+            }
+            if(!next || timer->due < next)
+                next = timer->due;
+        }
+        return nullptr;
+    }
+
+    void pin()
+    {
+        if(cpu<0)
+            return;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if(int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set))
+            errlogPrintf("SHARD%u: " ERL_WARNING ": unable to pin to CPU %d : %d\n", index, cpu, err);
+#else
+        errlogPrintf("SHARD%u: " ERL_WARNING ": CPU pinning not supported on this target\n", index);
+#endif
+    }
+
+    void run() override final
+    {
+        pin();
+
+        Guard G(lock);
+        while(true) {
+            uint64_t next;
+            if(auto timer = expired(next)) {
+                UnGuard U(G);
+                (*timer->cb)(timer->arg);
+                continue;
+            }
+            if(queue.empty()) {
+                UnGuard U(G);
+                if(next) {
+                    auto now = epicsMonotonicGet();
+                    wakeup.wait(next > now ? (next - now)*1e-9 : 0.0);
+                } else {
+                    wakeup.wait();
+                }
+                continue;
+            }
+            auto job = queue.front();
+            queue.pop_front();
+            // a request from here on needs another pass
+            job.scan->pending = false;
+
+            double latency = (epicsMonotonicGet() - job.mono)*1e-9;
+            lastLatency = latency;
+            if(latency > maxLatency)
+                maxLatency = latency;
+            nScans++;
+
+            UnGuard U(G);
+            auto scan = job.scan;
+            for(int prio=0; prio<NUM_CALLBACK_PRIORITIES; prio++) {
+                // no records at this priority, or not yet running
+                if(!scanIoImmediate(scan->scan, prio) && scan->cb)
+                    (*scan->cb)(scan->arg, scan->scan, prio);
+            }
+        }
+    }
+};
+
+} // namespace ospreyTiming
+
+namespace {
+using namespace ospreyTiming;
+
+epicsMutex shardsLock;
+// guarded by shardsLock.  Never free'd.
+std::vector<ScanShard*> shards;
+std::map<std::string, unsigned> shardAssign;
+unsigned shardNext = 0u;
+
+struct ShardDev {
+    ScanShard* const shard;
+
+    enum stat_t {
+        Depth, HWM, Count, Latency, MaxLatency,
+    } stat = Depth;
+
+    explicit ShardDev(ScanShard* shard)
+        :shard(shard)
+    {}
+};
+
+long scanShardInitRecord(dbCommon *prec) noexcept {
+    try {
+        auto plink(dbGetDevLink(prec));
+        assert(plink->type==INST_IO);
+        std::string lstr(plink->value.instio.string);
+
+        unsigned index = 0u;
+        ShardDev::stat_t stat = ShardDev::Depth;
+
+        char *saved = nullptr;
+        for(char* word = epicsStrtok_r((char*)lstr.data(), " ", &saved)
+             ; word
+             ; word = epicsStrtok_r(NULL, " ", &saved))
+        {
+            auto wlen = strlen(word);
+
+            auto cmd = [=](const char *pref) -> const char* {
+                auto plen = strlen(pref);
+                if(wlen >= plen && memcmp(word, pref, plen)==0) {
+                    return word + plen;
+                }
+                return nullptr;
+            };
+
+            if(auto val = cmd("shard=")) {
+                index = std::stoul(val, nullptr, 0);
+
+            } else if(auto val = cmd("stat=")) {
+                if(epicsStrCaseCmp(val, "depth")==0) {
+                    stat = ShardDev::Depth;
+                } else if(epicsStrCaseCmp(val, "hwm")==0) {
+                    stat = ShardDev::HWM;
+                } else if(epicsStrCaseCmp(val, "count")==0) {
+                    stat = ShardDev::Count;
+                } else if(epicsStrCaseCmp(val, "lat")==0) {
+                    stat = ShardDev::Latency;
+                } else if(epicsStrCaseCmp(val, "latmax")==0) {
+                    stat = ShardDev::MaxLatency;
+                } else {
+                    throw std::runtime_error("stat= must be 'depth', 'hwm', 'count', 'lat', or 'latmax'");
+                }
+
+            } else {
+                throw std::runtime_error("Unexpected dev. link parameter");
+            }
+        }
+
+        ScanShard* shard;
+        {
+            Guard G(shardsLock);
+            if(index >= shards.size())
+                throw std::runtime_error("No such shard=, see scanShardConfigure()");
+            shard = shards[index];
+        }
+
+        auto pvt = new ShardDev(shard);
+        pvt->stat = stat;
+        prec->dpvt = (void*)pvt;
+
+        return 0;
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", prec->name, e.what());
+        return -1;
+    }
+}
+
+long scanShardRead(aiRecord *prec) noexcept
+{
+    if(!prec->dpvt) {
+        recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "No Init");
+        return -1;
+    }
+    auto pvt = static_cast<ShardDev*>(prec->dpvt);
+    auto shard = pvt->shard;
+    Guard G(shard->lock);
+
+    switch(pvt->stat) {
+    case ShardDev::Depth: prec->val = shard->queue.size(); break;
+    case ShardDev::HWM: prec->val = shard->hwm; break;
+    case ShardDev::Count: prec->val = shard->nScans; break;
+    case ShardDev::Latency: prec->val = shard->lastLatency; break;
+    case ShardDev::MaxLatency: prec->val = shard->maxLatency; break;
+    }
+
+    return 2; // no conversion
+}
+
+aidset devScanShardStat = {
+    {6, nullptr, nullptr, scanShardInitRecord, nullptr},
+    scanShardRead, nullptr,
+};
+
+void scanShardConfigure(int nworkers, int prio, const char *cpuList)
+{
+    try {
+        if(nworkers<1 || nworkers>64)
+            throw std::runtime_error("workers must be 1-64");
+        if(prio<epicsThreadPriorityMin || prio>epicsThreadPriorityMax)
+            throw std::runtime_error("priority must be 0-99");
+
+        std::vector<int> cpus;
+        if(cpuList) {
+            std::string list(cpuList);
+            for(auto& c : list) {
+                if(c==',')
+                    c = ' ';
+            }
+            std::istringstream strm(list);
+            int cpu;
+            while(strm>>cpu) {
+                if(cpu<0)
+                    throw std::runtime_error("CPU numbers must be >=0");
+                cpus.push_back(cpu);
+            }
+            if(!strm.eof())
+                throw std::runtime_error("Invalid CPU list");
+        }
+
+        Guard G(shardsLock);
+        if(!shards.empty())
+            throw std::runtime_error("Already configured");
+
+        for(unsigned i=0u; i<unsigned(nworkers); i++) {
+            auto shard = new ScanShard(i, prio, cpus.empty() ? -1 : cpus[i % cpus.size()]);
+            shards.push_back(shard);
+            shard->worker.start();
+        }
+
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", __func__, e.what());
+    }
+}
+
+void scanShardAssign(const char *name, int index)
+{
+    try {
+        if(!name || !name[0])
+            throw std::runtime_error("Missing name");
+
+        Guard G(shardsLock);
+        if(index<0 || size_t(index)>=shards.size())
+            throw std::runtime_error("No such shard, see scanShardConfigure()");
+        if(shardAssign.find(name)!=shardAssign.end())
+            throw std::runtime_error("Already assigned");
+        shardAssign[name] = index;
+
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", __func__, e.what());
+    }
+}
+
+void scanShardReport(int level)
+{
+    Guard G(shardsLock);
+    if(shards.empty()) {
+        printf("No worker pool.  I/O Intr through callback queues\n");
+        return;
+    }
+    for(auto shard : shards) {
+        Guard G2(shard->lock);
+        printf("SHARD%u cpu=%d depth=%zu hwm=%zu scans=%llu coalesced=%llu latency=%.6f max=%.6f s\n",
+               shard->index, shard->cpu, shard->queue.size(), shard->hwm,
+               (unsigned long long)shard->nScans, (unsigned long long)shard->nCoalesced,
+               shard->lastLatency, shard->maxLatency);
+        if(level>0) {
+            for(auto& pair : shardAssign) {
+                if(pair.second==shard->index)
+                    printf("  %s\n", pair.first.c_str());
+            }
+        }
+    }
+}
+
+const iocshArg scanShardConfigureArg0 = {"workers", iocshArgInt};
+const iocshArg scanShardConfigureArg1 = {"priority", iocshArgInt};
+const iocshArg scanShardConfigureArg2 = {"CPU list", iocshArgString};
+const iocshArg * const scanShardConfigureArgs[] = {
+    &scanShardConfigureArg0, &scanShardConfigureArg1, &scanShardConfigureArg2,
+};
+const iocshFuncDef scanShardConfigureDef = {"scanShardConfigure", 3, scanShardConfigureArgs,
+                                            "Deliver Event Table and Bit Table I/O Intr scans from a pool of worker threads.\n"
+                                            "Priority is an EPICS thread priority 0-99, real-time when the IOC is permitted.\n"
+                                            "Optional comma separated CPU list, assigned to workers in turn.\n"};
+
+void scanShardConfigureCall(const iocshArgBuf *args)
+{
+    scanShardConfigure(args[0].ival, args[1].ival, args[2].sval);
+}
+
+const iocshArg scanShardAssignArg0 = {"name", iocshArgString};
+const iocshArg scanShardAssignArg1 = {"worker", iocshArgInt};
+const iocshArg * const scanShardAssignArgs[] = {&scanShardAssignArg0, &scanShardAssignArg1};
+const iocshFuncDef scanShardAssignDef = {"scanShardAssign", 2, scanShardAssignArgs,
+                                         "Assign named Event Table log, or Bit Table, to a worker.\n"
+                                         "Default is round robin.\n"};
+
+void scanShardAssignCall(const iocshArgBuf *args)
+{
+    scanShardAssign(args[0].sval, args[1].ival);
+}
+
+const iocshArg scanShardReportArg0 = {"level", iocshArgInt};
+const iocshArg * const scanShardReportArgs[] = {&scanShardReportArg0};
+const iocshFuncDef scanShardReportDef = {"scanShardReport", 1, scanShardReportArgs,
+                                         "Show worker statistics.  Level 1 lists assignments.\n"};
+
+void scanShardReportCall(const iocshArgBuf *args)
+{
+    scanShardReport(args[0].ival);
+}
+
+void scanShardRegistrar()
+{
+    iocshRegister(&scanShardConfigureDef, scanShardConfigureCall);
+    iocshRegister(&scanShardAssignDef, scanShardAssignCall);
+    iocshRegister(&scanShardReportDef, scanShardReportCall);
+}
+
+} // namespace
+
+namespace ospreyTiming {
+
+ScanShard* scanShardFor(const std::string& name)
+{
+    Guard G(shardsLock);
+    if(shards.empty())
+        return nullptr;
+
+    auto it = shardAssign.find(name);
+    if(it==shardAssign.end()) {
+        it = shardAssign.emplace(name, shardNext).first;
+        shardNext = (shardNext+1u) % shards.size();
+    }
+    return shards[it->second];
+}
+
+void shardScanInit(ShardScan& scan, ScanShard* shard, io_scan_complete cb, void *arg)
+{
+    scanIoInit(&scan.scan);
+    if(cb)
+        scanIoSetComplete(scan.scan, cb, arg);
+    scan.cb = cb;
+    scan.arg = arg;
+    scan.shard = shard;
+}
+
+void shardScanAssign(ShardScan& scan, const std::string& name)
+{
+    if(!scan.shard)
+        scan.shard = scanShardFor(name);
+}
+
+unsigned shardScanRequest(ShardScan& scan)
+{
+    if(!scan.shard)
+        return scanIoRequest(scan.scan);
+
+    scan.shard->request(scan);
+    return (1u<<NUM_CALLBACK_PRIORITIES)-1u;
+}
+
+static
+void shardTimerFallback(epicsCallback *pcb)
+{
+    void *usr;
+    callbackGetUser(usr, pcb);
+    auto timer = static_cast<ShardTimer*>(usr);
+    (*timer->cb)(timer->arg);
+}
+
+void shardTimerInit(ShardTimer& timer, ScanShard* shard, void (*cb)(void *arg), void *arg)
+{
+    timer.cb = cb;
+    timer.arg = arg;
+    timer.shard = shard;
+    memset(&timer.fallback, 0, sizeof(timer.fallback));
+    callbackSetCallback(shardTimerFallback, &timer.fallback);
+    callbackSetUser(&timer, &timer.fallback);
+    callbackSetPriority(priorityLow, &timer.fallback);
+}
+
+void shardTimerRequest(ShardTimer& timer, double delay)
+{
+    if(!timer.shard) {
+        callbackRequestDelayed(&timer.fallback, delay);
+    } else {
+        timer.shard->requestDelayed(timer, delay);
+    }
+}
+
+} // namespace ospreyTiming
+
+extern "C" {
+epicsExportAddress(dset, devScanShardStat);
+epicsExportRegistrar(scanShardRegistrar);
+}
@@ -0,0 +1,73 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* I/O Intr delivery through per-node worker threads, internal interface
+ *
+ * cf. scanShard.cpp
+ */
+#ifndef SCANSHARD_H
+#define SCANSHARD_H
+
+#include <string>
+
+#include <dbScan.h>
+#include <callback.h>
+
+namespace ospreyTiming {
+
+struct ScanShard;
+
+/* Wraps an IOSCANPVT and its completion callback.  When a shard is
+ * assigned, requests are delivered by that shard's worker thread instead
+ * of the shared callback queues.
+ */
+struct ShardScan {
+    IOSCANPVT scan = nullptr;
+    io_scan_complete cb = nullptr;
+    void *arg = nullptr;
+    ScanShard *shard = nullptr;
+    bool pending = false; // queued, not yet started.  guarded by shard lock
+};
+
+/* A delayed call, run by a shard's worker thread.  Without a shard,
+ * by a priorityLow callback thread.
+ */
+struct ShardTimer {
+    void (*cb)(void *arg) = nullptr;
+    void *arg = nullptr;
+    ScanShard *shard = nullptr;
+    epicsCallback fallback; // without shard
+    bool armed = false; // guarded by shard lock
+    uint64_t due = 0u; // epicsMonotonicGet().  guarded by shard lock
+};
+
+/* Shard for the named EventLog/BitTable, or nullptr if no worker pool is
+ * configured.  Assignment is fixed on first call for each name.
+ */
+ScanShard* scanShardFor(const std::string& name);
+
+// scanIoInit() and scanIoSetComplete().  cb may be nullptr
+void shardScanInit(ShardScan& scan, ScanShard* shard, io_scan_complete cb, void *arg);
+
+/* For an owner whose EventLog is only known later.  Assign the shard of
+ * the named log, unless already assigned.  Call before the first request.
+ */
+void shardScanAssign(ShardScan& scan, const std::string& name);
+
+/* As scanIoRequest().  Returns the mask of priorities for which cb will
+ * be called.  A request while one is already queued, and not yet started,
+ * is merged into it.
+ */
+unsigned shardScanRequest(ShardScan& scan);
+
+void shardTimerInit(ShardTimer& timer, ScanShard* shard, void (*cb)(void *arg), void *arg);
+
+/* As callbackRequestDelayed().  Re-arming before expiry replaces the
+ * delay.  cb is called without any lock held.
+ */
+void shardTimerRequest(ShardTimer& timer, double delay);
+
+} // namespace ospreyTiming
+
+#endif // SCANSHARD_H
@@ -5,7 +5,10 @@
 /** EVG sequence table mux
  */
 
+#include <string.h>
+
 #include <epicsTypes.h>
+#include <menuFtype.h>
 #include <aSubRecord.h>
 #include <recGbl.h>
 #include <alarm.h>
@@ -63,6 +66,11 @@ long timingSeqMux(aSubRecord *prec)
 
     prec->neva = 2*N;
 
+    if(prec->ftvb==menuFtypeULONG && prec->novb>=2*N) {
+        memcpy(prec->valb, out, 2*N*sizeof(*out));
+        prec->nevb = 2*N;
+    }
+
     return 0;
 }
 
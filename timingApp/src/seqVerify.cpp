@@ -0,0 +1,535 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* EVG sequencer execution verification
+ *
+ * The (code, delay) pairs last uploaded to a sequencer bank, as produced
+ * by timingSeqMux, are matched against the EventLog of a loopback EVR
+ * (fiber pair 3 by convention).  Each delay (ns) is relative to the
+ * previous entry.  Entries with code 0 are not emitted, but their delay
+ * counts.
+ *
+ * The code of entry 0 starts a pass.  Later entries are timed relative
+ * to the arrival of entry 0.  An entry skipped over by a later match, or
+ * not seen before the last entry is overdue, counts as missed.  Codes of
+ * the pattern seen outside of the expected order count as unexpected.
+ *
+ * Matching is incremental, per EventLog batch, with a per code index of
+ * entries.  So each event is O(log N).
+ *
+ * The loopback EventLog carries the output of every bank.  So matching is
+ * disabled until enabled through "Seq Verify Enable", which should only be
+ * done for a bank which is actually triggered.
+ *
+ * Output:
+ *   - passes, matched, missed, unexpected, out of tolerance counts (longin)
+ *   - per entry expected offset, match and miss counts, and timing error
+ *     last, mean, std. dev., min, max (aai indexed by entry)
+ */
+
+#include <map>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define USE_TYPED_RSET
+#define USE_TYPED_DSET
+
+#include <epicsTypes.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsString.h>
+#include <epicsStdio.h>
+#include <epicsTime.h>
+#include <epicsMath.h>
+#include <errlog.h>
+
+#include <alarm.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <devSup.h>
+#include <recGbl.h>
+#include <dbCommon.h>
+#include <aaiRecord.h>
+#include <aaoRecord.h>
+#include <longinRecord.h>
+#include <longoutRecord.h>
+#include <menuFtype.h>
+
+#include <epicsExport.h>
+
+#include "eventTable.h"
+#include "scanShard.h"
+
+namespace {
+using namespace ospreyTiming;
+
+typedef epicsGuard<epicsMutex> Guard;
+
+struct SeqVerifier;
+
+epicsMutex verifiersLock;
+std::map<std::string, std::unique_ptr<SeqVerifier>> verifiers;
+
+struct SeqVerifier : public EventLogObserver {
+    epicsMutex lock;
+
+    std::string logName; // empty until attached
+    int64_t tolerance = 1000; // ns
+    bool enabled = false;
+
+    struct Entry {
+        uint8_t code = 0u;
+        int64_t offset = 0; // ns after entry 0
+
+        uint32_t missed = 0u;
+        RunningStat err; // ns, of matches
+    };
+    std::vector<Entry> pattern;
+    std::vector<std::vector<uint32_t>> byCode; // [code] -> ascending entry indices
+    size_t first = 0u; // index of first emitted entry
+
+    // matching state
+    size_t pos = 0u; // next expected entry, 0 when idle
+    epicsTimeStamp t0;
+    epicsTimeStamp tLast; // of last match
+
+    uint32_t nPasses = 0u, nMatched = 0u, nMissed = 0u, nUnexpected = 0u, nOutOfTol = 0u;
+
+    ShardScan onChange; // on the shard of the EventLog, once attached
+    unsigned changing=0u;
+
+    SeqVerifier()
+        :byCode(256u)
+    {
+        t0.secPastEpoch = t0.nsec = 0u;
+        tLast = t0;
+        shardScanInit(onChange, nullptr, onChangeComplete, this);
+    }
+    virtual ~SeqVerifier() {}
+
+    static
+    SeqVerifier* getCreate(const std::string& name) {
+        Guard G(verifiersLock);
+        auto& ent = verifiers[name];
+        if(!ent)
+            ent.reset(new SeqVerifier);
+        return ent.get();
+    }
+
+    // must lock
+    void changed()
+    {
+        if(!changing)
+            changing = shardScanRequest(onChange);
+    }
+
+    // must lock.  pairs as from timingSeqMux
+    void load(const epicsUInt32 *pairs, size_t npairs)
+    {
+        pattern.clear();
+        for(auto& idx : byCode)
+            idx.clear();
+
+        int64_t offset = 0;
+        bool started = false;
+        for(size_t i=0u; i<npairs; i++) {
+            auto code = pairs[2u*i+0u];
+            if(code>255u)
+                throw std::runtime_error("Invalid event code in pattern");
+
+            if(started)
+                offset += pairs[2u*i+1u];
+
+            if(!code)
+                continue;
+            started = true;
+
+            Entry ent;
+            ent.code = code;
+            ent.offset = offset;
+            byCode[code].push_back(pattern.size());
+            pattern.push_back(ent);
+        }
+
+        pos = 0u;
+        nPasses = nMatched = nMissed = nUnexpected = nOutOfTol = 0u;
+        changed();
+    }
+
+    // must lock
+    void enable(bool ena)
+    {
+        if(ena==enabled)
+            return;
+        enabled = ena;
+        pos = 0u; // abandon any pass in progress
+        changed();
+    }
+
+    // must lock.  entries [pos, end) not seen
+    void skip(size_t end)
+    {
+        for(; pos<end; pos++) {
+            pattern[pos].missed++;
+            nMissed++;
+        }
+    }
+
+    // must lock
+    void endPass()
+    {
+        skip(pattern.size());
+        nPasses++;
+        pos = 0u;
+    }
+
+    // must lock
+    void match(size_t idx, const epicsTimeStamp& ts)
+    {
+        skip(idx);
+
+        auto& ent = pattern[idx];
+        double err = double(diffNS(ts, t0) - ent.offset);
+
+        ent.err.add(err);
+
+        nMatched++;
+        if(fabs(err) > tolerance)
+            nOutOfTol++;
+        tLast = ts;
+
+        pos = idx+1u;
+        if(pos==pattern.size()) {
+            nPasses++;
+            pos = 0u;
+        }
+    }
+
+    virtual void onEvents(const EventRec* recs, size_t nrecs) override final
+    {
+        Guard G(lock);
+        if(!enabled || pattern.empty())
+            return;
+
+        bool update = false;
+        for(size_t i=0u; i<nrecs; i++) {
+            auto& rec = recs[i];
+
+            if(pos && diffNS(rec.ts, t0) > pattern.back().offset + tolerance) {
+                endPass(); // remainder overdue
+                update = true;
+            }
+
+            auto& idx = byCode[rec.code];
+            if(idx.empty())
+                continue;
+            update = true;
+
+            if(pos) {
+                // first entry with this code not before the expected entry
+                auto it = std::lower_bound(idx.begin(), idx.end(), uint32_t(pos));
+                if(it!=idx.end()) {
+                    match(*it, rec.ts);
+                    continue;
+                }
+            }
+
+            if(rec.code==pattern[0].code) {
+                if(pos)
+                    endPass(); // restarted
+                t0 = rec.ts;
+                match(0u, rec.ts);
+            } else {
+                nUnexpected++;
+            }
+        }
+
+        if(update)
+            changed();
+    }
+
+    static
+    void onChangeComplete(void *usr, IOSCANPVT, int prio) noexcept
+    {
+        auto self=static_cast<SeqVerifier*>(usr);
+        try {
+            unsigned mask = 1u<<prio;
+            Guard G(self->lock);
+            assert(self->changing & mask);
+            self->changing &= ~mask;
+
+        }catch(std::exception& e){
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", __func__, e.what());
+        }
+    }
+};
+
+struct VerifyDev {
+    SeqVerifier* const verifier;
+
+    enum stat_t {
+        Passes, Matched, Missed, Unexpected, OutOfTol, Entries,
+        Expected, Last, Mean, Std, Min, Max,
+    } stat = Passes;
+
+    explicit VerifyDev(SeqVerifier* verifier)
+        :verifier(verifier)
+    {}
+};
+
+long verifyInitRecord(dbCommon *prec) noexcept {
+    try {
+        auto plink(dbGetDevLink(prec));
+        assert(plink->type==INST_IO);
+        std::string lstr(plink->value.instio.string);
+
+        std::string verifyName, logName;
+        int64_t tolerance = -1;
+        VerifyDev::stat_t stat = VerifyDev::Passes;
+
+        char *saved = nullptr;
+        for(char* word = epicsStrtok_r((char*)lstr.data(), " ", &saved)
+             ; word
+             ; word = epicsStrtok_r(NULL, " ", &saved))
+        {
+            auto wlen = strlen(word);
+
+            auto cmd = [=](const char *pref) -> const char* {
+                auto plen = strlen(pref);
+                if(wlen >= plen && memcmp(word, pref, plen)==0) {
+                    return word + plen;
+                }
+                return nullptr;
+            };
+
+            if(auto val = cmd("verify=")) {
+                verifyName = val;
+
+            } else if(auto val = cmd("log=")) {
+                logName = val;
+
+            } else if(auto val = cmd("tol=")) {
+                tolerance = std::stoll(val, nullptr, 0);
+                if(tolerance<0)
+                    throw std::runtime_error("tol= must be >=0");
+
+            } else if(auto val = cmd("stat=")) {
+                if(epicsStrCaseCmp(val, "passes")==0) {
+                    stat = VerifyDev::Passes;
+                } else if(epicsStrCaseCmp(val, "matched")==0) {
+                    stat = VerifyDev::Matched;
+                } else if(epicsStrCaseCmp(val, "missed")==0) {
+                    stat = VerifyDev::Missed;
+                } else if(epicsStrCaseCmp(val, "unexpected")==0) {
+                    stat = VerifyDev::Unexpected;
+                } else if(epicsStrCaseCmp(val, "outOfTol")==0) {
+                    stat = VerifyDev::OutOfTol;
+                } else if(epicsStrCaseCmp(val, "entries")==0) {
+                    stat = VerifyDev::Entries;
+                } else if(epicsStrCaseCmp(val, "expected")==0) {
+                    stat = VerifyDev::Expected;
+                } else if(epicsStrCaseCmp(val, "last")==0) {
+                    stat = VerifyDev::Last;
+                } else if(epicsStrCaseCmp(val, "mean")==0) {
+                    stat = VerifyDev::Mean;
+                } else if(epicsStrCaseCmp(val, "std")==0) {
+                    stat = VerifyDev::Std;
+                } else if(epicsStrCaseCmp(val, "min")==0) {
+                    stat = VerifyDev::Min;
+                } else if(epicsStrCaseCmp(val, "max")==0) {
+                    stat = VerifyDev::Max;
+                } else {
+                    throw std::runtime_error("stat= must be 'passes', 'matched', 'missed', 'unexpected', 'outOfTol', 'entries',"
+                                             " 'expected', 'last', 'mean', 'std', 'min', or 'max'");
+                }
+
+            } else {
+                throw std::runtime_error("Unexpected dev. link parameter");
+            }
+        }
+
+        if(verifyName.empty())
+            throw std::runtime_error("Missing verify=");
+
+        auto verifier = SeqVerifier::getCreate(verifyName);
+        bool attach = false;
+        {
+            Guard G(verifier->lock);
+
+            if(tolerance>=0)
+                verifier->tolerance = tolerance;
+
+            if(!logName.empty()) {
+                if(verifier->logName.empty()) {
+                    verifier->logName = logName;
+                    shardScanAssign(verifier->onChange, logName);
+                    attach = true;
+                } else if(verifier->logName!=logName) {
+                    throw std::runtime_error("verify= already has different log=");
+                }
+            }
+        }
+        // never free'd
+        if(attach)
+            eventLogAttach(logName, verifier);
+
+        auto pvt = new VerifyDev(verifier);
+        pvt->stat = stat;
+        prec->dpvt = (void*)pvt;
+
+        return 0;
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", prec->name, e.what());
+        return -1;
+    }
+}
+
+long verifyChanged(int detach, struct dbCommon *prec, IOSCANPVT* pscan) noexcept
+{
+    (void)detach;
+    auto pvt = static_cast<VerifyDev*>(prec->dpvt);
+    if(!pvt)
+        return -1;
+
+    *pscan = pvt->verifier->onChange.scan;
+    return 0;
+}
+
+#define TRY \
+    if(!prec->dpvt) { \
+            recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "No Init"); \
+            return -1; \
+    } \
+    auto pvt = static_cast<VerifyDev*>(prec->dpvt); \
+    try
+
+#define CATCH \
+    catch(std::exception& e){ \
+        recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "%s", e.what()); \
+        if(prec->tpro) \
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", prec->name, e.what()); \
+        return -1; \
+}
+
+long verifyPattern(aaoRecord *prec) noexcept
+{
+    if(prec->ftvl!=menuFtypeULONG) {
+        recGblSetSevrMsg(prec, WRITE_ALARM, INVALID_ALARM, "Bad FTVL");
+        return -1;
+    }
+
+    TRY {
+        auto verifier = pvt->verifier;
+        Guard G(verifier->lock);
+
+        verifier->load(static_cast<const epicsUInt32*>(prec->bptr), prec->nord/2u);
+
+        return 0;
+    } CATCH
+}
+
+long verifyEnable(longoutRecord *prec) noexcept
+{
+    TRY {
+        auto verifier = pvt->verifier;
+        Guard G(verifier->lock);
+
+        verifier->enable(prec->val!=0);
+
+        return 0;
+    } CATCH
+}
+
+long verifyStat(longinRecord *prec) noexcept
+{
+    TRY {
+        auto verifier = pvt->verifier;
+        Guard G(verifier->lock);
+
+        switch(pvt->stat) {
+        case VerifyDev::Passes: prec->val = verifier->nPasses; break;
+        case VerifyDev::Matched: prec->val = verifier->nMatched; break;
+        case VerifyDev::Missed: prec->val = verifier->nMissed; break;
+        case VerifyDev::Unexpected: prec->val = verifier->nUnexpected; break;
+        case VerifyDev::OutOfTol: prec->val = verifier->nOutOfTol; break;
+        case VerifyDev::Entries: prec->val = verifier->pattern.size(); break;
+        default:
+            throw std::runtime_error("stat= not applicable");
+        }
+        prec->time = verifier->tLast;
+
+        return 0;
+    } CATCH
+}
+
+long verifyEntry(aaiRecord *prec) noexcept
+{
+    if(prec->ftvl!=menuFtypeDOUBLE) {
+        recGblSetSevrMsg(prec, READ_ALARM, INVALID_ALARM, "Bad FTVL");
+        return -1;
+    }
+
+    auto val = static_cast<double*>(prec->bptr);
+
+    TRY {
+        auto verifier = pvt->verifier;
+        Guard G(verifier->lock);
+
+        epicsUInt32 n = 0u;
+        for(; n<prec->nelm && n<verifier->pattern.size(); n++) {
+            auto& ent = verifier->pattern[n];
+            double v = epicsNAN;
+            switch(pvt->stat) {
+            case VerifyDev::Matched: v = ent.err.value(RunningStat::Count); break;
+            case VerifyDev::Missed: v = ent.missed; break;
+            case VerifyDev::Expected: v = ent.offset; break;
+            case VerifyDev::Last: v = ent.err.value(RunningStat::Last); break;
+            case VerifyDev::Mean: v = ent.err.value(RunningStat::Mean); break;
+            case VerifyDev::Std: v = ent.err.value(RunningStat::Std); break;
+            case VerifyDev::Min: v = ent.err.value(RunningStat::Min); break;
+            case VerifyDev::Max: v = ent.err.value(RunningStat::Max); break;
+            default:
+                throw std::runtime_error("stat= not applicable");
+            }
+            val[n] = v;
+        }
+        prec->nord = n;
+        prec->time = verifier->tLast;
+
+        return 0;
+    } CATCH
+}
+
+aaodset devSeqVerifyPattern = {
+    {5, nullptr, nullptr, verifyInitRecord, nullptr},
+    verifyPattern,
+};
+longoutdset devSeqVerifyEnable = {
+    {5, nullptr, nullptr, verifyInitRecord, nullptr},
+    verifyEnable,
+};
+longindset devSeqVerifyStat = {
+    {5, nullptr, nullptr, verifyInitRecord, verifyChanged},
+    verifyStat,
+};
+aaidset devSeqVerifyEntry = {
+    {5, nullptr, nullptr, verifyInitRecord, verifyChanged},
+    verifyEntry,
+};
+
+} // namespace
+
+extern "C" {
+epicsExportAddress(dset, devSeqVerifyPattern);
+epicsExportAddress(dset, devSeqVerifyEnable);
+epicsExportAddress(dset, devSeqVerifyStat);
+epicsExportAddress(dset, devSeqVerifyEntry);
+}
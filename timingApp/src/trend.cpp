@@ -0,0 +1,599 @@
+/*************************************************************************\
+* Copyright (c) 2026 Osprey Distributed Control Systems
+* SPDX-License-Identifier: BSD
+\*************************************************************************/
+/* Decimating trend history of one scalar
+ *
+ * Samples are pushed in (eg. from a periodic register read) and accumulated
+ * into fixed width time buckets.  eg. 1 second, 1 minute, and 1 hour.
+ * Each completed bucket is appended to a ring of min/max/mean, and is fed
+ * into the accumulator of the next wider tier.  Buckets with no samples
+ * are kept as NaN so that gaps are visible.
+ *
+ * Optionally, the most recent raw samples are also kept in a preallocated
+ * ring.  A trigger (eg. a PPS source or clock mux change) freezes a snapshot
+ * of this ring once enough samples have been taken after the trigger.
+ *
+ * Output:
+ *   - bucket start time, min, max, and mean of each tier (aai)
+ *   - snapshot time relative to trigger, and value (aai)
+ */
+
+#include <map>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <deque>
+#include <vector>
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define USE_TYPED_DRVET
+#define USE_TYPED_RSET
+#define USE_TYPED_DSET
+
+#include <epicsTypes.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsString.h>
+#include <epicsStdio.h>
+#include <epicsTime.h>
+#include <epicsMath.h>
+#include <errlog.h>
+
+#include <alarm.h>
+#include <dbAccess.h>
+#include <dbScan.h>
+#include <devSup.h>
+#include <recGbl.h>
+#include <dbCommon.h>
+#include <aoRecord.h>
+#include <aaiRecord.h>
+#include <longoutRecord.h>
+#include <menuFtype.h>
+
+#include <epicsExport.h>
+
+#include "scanShard.h"
+
+namespace {
+using namespace ospreyTiming;
+
+typedef epicsGuard<epicsMutex> Guard;
+
+struct Trend;
+
+struct Tier {
+    struct Bucket {
+        double time; // start, POSIX seconds
+        double min, max, mean;
+    };
+
+    Trend* const owner;
+    const double width; // seconds
+
+    // accumulator of current bucket
+    int64_t idx = INT64_MIN; // floor(time/width)
+    double min = 0.0, max = 0.0, sum = 0.0;
+    size_t n = 0u;
+
+    // completed, oldest first
+    std::deque<Bucket> hist;
+
+    ShardScan onUpdate;
+    unsigned changing = 0u;
+
+    Tier(Trend* owner, double width);
+
+    static
+    void onUpdateComplete(void *usr, IOSCANPVT, int prio) noexcept;
+};
+
+struct Trend {
+    struct Raw {
+        double time; // POSIX seconds
+        double val;
+    };
+
+    epicsMutex lock;
+
+    size_t keep = 600u; // buckets per tier
+    std::vector<std::unique_ptr<Tier>> tiers;
+
+    // raw ring, empty when not configured
+    std::vector<Raw> raw;
+    size_t rawHead = 0u; // next to be written
+    size_t rawCount = 0u;
+    size_t pre = 0u; // samples kept before trigger
+
+    // triggered snapshot
+    bool armed = false;
+    size_t postRemain = 0u;
+    double trigTime = 0.0;
+    std::vector<Raw> snap; // oldest first.  times relative to trigger
+    ShardScan onSnap;
+    unsigned snapChanging = 0u;
+
+    ScanShard* const shard; // for onSnap and Tier::onUpdate, by trend name
+
+    explicit
+    Trend(const std::string& name)
+        :shard(scanShardFor(name))
+    {
+        shardScanInit(onSnap, shard, onSnapComplete, this);
+    }
+
+    static
+    void onSnapComplete(void *usr, IOSCANPVT, int prio) noexcept
+    {
+        auto self=static_cast<Trend*>(usr);
+        try {
+            unsigned mask = 1u<<prio;
+            Guard G(self->lock);
+            assert(self->snapChanging & mask);
+            self->snapChanging &= ~mask;
+
+        }catch(std::exception& e){
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", __func__, e.what());
+        }
+    }
+
+    void configureRaw(size_t len, size_t npre)
+    {
+        if(!raw.empty())
+            throw std::runtime_error("raw= already set");
+        if(npre>=len)
+            throw std::runtime_error("pre= must be less than raw=");
+        raw.resize(len);
+        snap.reserve(len);
+        pre = npre;
+    }
+
+    // must lock
+    void trigger(double time)
+    {
+        if(raw.empty())
+            throw std::runtime_error("No raw= ring");
+        if(armed)
+            return; // snapshot of earlier trigger includes this one
+        armed = true;
+        trigTime = time;
+        postRemain = raw.size() - pre;
+    }
+
+    void configure(const std::vector<double>& widths)
+    {
+        if(!tiers.empty())
+            throw std::runtime_error("tiers= already set");
+
+        double prev = 0.0;
+        for(auto w : widths) {
+            if(!isfinite(w) || w<=prev)
+                throw std::runtime_error("tiers= must be increasing, and >0");
+            tiers.emplace_back(new Tier(this, w));
+            prev = w;
+        }
+    }
+
+    // must lock
+    void add(double time, double val)
+    {
+        add(0u, time, val, val, val, 1u);
+
+        if(raw.empty())
+            return;
+
+        raw[rawHead] = Raw{time, val};
+        rawHead = (rawHead+1u) % raw.size();
+        if(rawCount < raw.size())
+            rawCount++;
+
+        if(armed && --postRemain==0u) {
+            armed = false;
+            snap.clear();
+            for(size_t i=0u; i<rawCount; i++) {
+                auto& ent = raw[(rawHead + raw.size() - rawCount + i) % raw.size()];
+                snap.push_back(Raw{ent.time - trigTime, ent.val});
+            }
+            if(!snapChanging)
+                snapChanging = shardScanRequest(onSnap);
+        }
+    }
+
+    // must lock
+    void add(size_t t, double time, double min, double max, double sum, size_t n)
+    {
+        if(t>=tiers.size())
+            return;
+        auto& tier = *tiers[t];
+
+        auto idx = int64_t(floor(time/tier.width));
+
+        if(tier.idx==INT64_MIN) {
+            tier.idx = idx;
+
+        } else if(idx > tier.idx) {
+            // bucket complete
+            Tier::Bucket ent{tier.idx*tier.width, tier.min, tier.max, tier.sum/tier.n};
+            push(tier, ent);
+            add(t+1u, ent.time, tier.min, tier.max, tier.sum, tier.n);
+
+            // gaps
+            auto gap = idx - tier.idx - 1;
+            if(gap > int64_t(keep))
+                gap = keep;
+            for(auto i = idx-gap; i<idx; i++)
+                push(tier, Tier::Bucket{i*tier.width, epicsNAN, epicsNAN, epicsNAN});
+
+            if(!tier.changing)
+                tier.changing = shardScanRequest(tier.onUpdate);
+
+            tier.idx = idx;
+            tier.n = 0u;
+        }
+        // else late sample goes into current bucket
+
+        if(tier.n==0u) {
+            tier.min = min;
+            tier.max = max;
+            tier.sum = sum;
+        } else {
+            if(min < tier.min)
+                tier.min = min;
+            if(max > tier.max)
+                tier.max = max;
+            tier.sum += sum;
+        }
+        tier.n += n;
+    }
+
+    void push(Tier& tier, const Tier::Bucket& ent)
+    {
+        tier.hist.push_back(ent);
+        while(tier.hist.size() > keep)
+            tier.hist.pop_front();
+    }
+};
+
+Tier::Tier(Trend* owner, double width)
+    :owner(owner)
+    ,width(width)
+{
+    shardScanInit(onUpdate, owner->shard, onUpdateComplete, this);
+}
+
+void Tier::onUpdateComplete(void *usr, IOSCANPVT, int prio) noexcept
+{
+    auto self=static_cast<Tier*>(usr);
+    try {
+        unsigned mask = 1u<<prio;
+        Guard G(self->owner->lock);
+        assert(self->changing & mask);
+        self->changing &= ~mask;
+
+    }catch(std::exception& e){
+        errlogPrintf("%s: " ERL_ERROR ": %s\n", __func__, e.what());
+    }
+}
+
+epicsMutex trendsLock;
+std::map<std::string, std::unique_ptr<Trend>> trends;
+
+Trend* trendGetCreate(const std::string& name)
+{
+    Guard G(trendsLock);
+    auto& ent = trends[name];
+    if(!ent)
+        ent.reset(new Trend(name));
+    return ent.get();
+}
+
+struct TrendDev {
+    dbCommon* const prec;
+    Trend* const trend;
+
+    size_t tier = 0u;
+    enum stat_t {
+        Time, Min, Max, Mean, Val,
+    } stat = Mean;
+
+    TrendDev(dbCommon *prec, Trend* trend)
+        :prec(prec), trend(trend)
+    {}
+};
+
+long trendInitRecord(dbCommon *prec) noexcept {
+    try {
+        auto plink(dbGetDevLink(prec));
+        assert(plink->type==INST_IO);
+        std::string lstr(plink->value.instio.string);
+
+        std::string trendName;
+        std::vector<double> widths;
+        size_t keep = 0u;
+        size_t rawLen = 0u, pre = 0u;
+        size_t tier = 0u;
+        TrendDev::stat_t stat = TrendDev::Mean;
+
+        char *saved = nullptr;
+        for(char* word = epicsStrtok_r((char*)lstr.data(), " ", &saved)
+             ; word
+             ; word = epicsStrtok_r(NULL, " ", &saved))
+        {
+            auto wlen = strlen(word);
+
+            auto cmd = [=](const char *pref) -> const char* {
+                auto plen = strlen(pref);
+                if(wlen >= plen && memcmp(word, pref, plen)==0) {
+                    return word + plen;
+                }
+                return nullptr;
+            };
+
+            if(auto val = cmd("trend=")) {
+                trendName = val;
+
+            } else if(auto val = cmd("tiers=")) {
+                std::string list(val);
+                size_t pos = 0u;
+                while(pos < list.size()) {
+                    auto sep = list.find(',', pos);
+                    if(sep==std::string::npos)
+                        sep = list.size();
+                    widths.push_back(std::stod(list.substr(pos, sep-pos)));
+                    pos = sep+1u;
+                }
+
+            } else if(auto val = cmd("keep=")) {
+                keep = std::stoul(val, nullptr, 0);
+
+            } else if(auto val = cmd("raw=")) {
+                rawLen = std::stoul(val, nullptr, 0);
+
+            } else if(auto val = cmd("pre=")) {
+                pre = std::stoul(val, nullptr, 0);
+
+            } else if(auto val = cmd("tier=")) {
+                tier = std::stoul(val, nullptr, 0);
+
+            } else if(auto val = cmd("stat=")) {
+                if(epicsStrCaseCmp(val, "time")==0) {
+                    stat = TrendDev::Time;
+                } else if(epicsStrCaseCmp(val, "min")==0) {
+                    stat = TrendDev::Min;
+                } else if(epicsStrCaseCmp(val, "max")==0) {
+                    stat = TrendDev::Max;
+                } else if(epicsStrCaseCmp(val, "mean")==0) {
+                    stat = TrendDev::Mean;
+                } else if(epicsStrCaseCmp(val, "val")==0) {
+                    stat = TrendDev::Val;
+                } else {
+                    throw std::runtime_error("stat= must be 'time', 'min', 'max', 'mean', or 'val'");
+                }
+
+            } else {
+                throw std::runtime_error("Unexpected dev. link parameter");
+            }
+        }
+
+        if(trendName.empty())
+            throw std::runtime_error("Missing trend=");
+
+        auto trend = trendGetCreate(trendName);
+        {
+            Guard G(trend->lock);
+            if(!widths.empty())
+                trend->configure(widths);
+            if(keep)
+                trend->keep = keep;
+            if(rawLen)
+                trend->configureRaw(rawLen, pre);
+        }
+
+        auto pvt = new TrendDev(prec, trend);
+        pvt->tier = tier;
+        pvt->stat = stat;
+        prec->dpvt = (void*)pvt;
+
+        return 0;
+    } catch(std::exception& e){
+        fprintf(stderr, "%s " ERL_ERROR ": %s\n", prec->name, e.what());
+        return -1;
+    }
+}
+
+long trendInitRecordHist(dbCommon *prec) noexcept {
+    if(auto ret = trendInitRecord(prec))
+        return ret;
+
+    // tiers= may be given by a later record, so tier= is checked by trendChanged()
+    auto pvt = static_cast<TrendDev*>(prec->dpvt);
+    if(reinterpret_cast<aaiRecord*>(prec)->ftvl!=menuFtypeDOUBLE) {
+        fprintf(stderr, "%s " ERL_ERROR ": FTVL must be DOUBLE\n", prec->name);
+        return -1;
+    }
+    if(pvt->stat==TrendDev::Val) {
+        fprintf(stderr, "%s " ERL_ERROR ": stat=val only for Trend Snapshot\n", prec->name);
+        return -1;
+    }
+    return 0;
+}
+
+long trendInitRecordSnap(dbCommon *prec) noexcept {
+    if(auto ret = trendInitRecord(prec))
+        return ret;
+
+    auto pvt = static_cast<TrendDev*>(prec->dpvt);
+    if(reinterpret_cast<aaiRecord*>(prec)->ftvl!=menuFtypeDOUBLE) {
+        fprintf(stderr, "%s " ERL_ERROR ": FTVL must be DOUBLE\n", prec->name);
+        return -1;
+    }
+    if(pvt->stat!=TrendDev::Time && pvt->stat!=TrendDev::Val) {
+        fprintf(stderr, "%s " ERL_ERROR ": stat= must be 'time' or 'val'\n", prec->name);
+        return -1;
+    }
+    return 0;
+}
+
+long trendChanged(int detach, struct dbCommon *prec, IOSCANPVT* pscan) noexcept
+{
+    (void)detach;
+    auto pvt = static_cast<TrendDev*>(prec->dpvt);
+    if(!pvt)
+        return -1;
+
+    Guard G(pvt->trend->lock);
+    if(pvt->tier >= pvt->trend->tiers.size()) {
+        fprintf(stderr, "%s " ERL_ERROR ": tier= out of range\n", prec->name);
+        return -1;
+    }
+    *pscan = pvt->trend->tiers[pvt->tier]->onUpdate.scan;
+    return 0;
+}
+
+#define TRY \
+    if(!prec->dpvt) { \
+            recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "No Init"); \
+            return -1; \
+    } \
+    auto pvt = static_cast<TrendDev*>(prec->dpvt); \
+    try
+
+#define CATCH \
+    catch(std::exception& e){ \
+        recGblSetSevrMsg(prec, COMM_ALARM, INVALID_ALARM, "%s", e.what()); \
+        if(prec->tpro) \
+            errlogPrintf("%s: " ERL_ERROR ": %s\n", prec->name, e.what()); \
+        return -1; \
+}
+
+long trendSample(aoRecord *prec) noexcept
+{
+    if(prec->nsev>=INVALID_ALARM)
+        return 0; // source read failed, leave a gap
+
+    if(!isfinite(prec->val)) {
+        recGblSetSevrMsg(prec, WRITE_ALARM, INVALID_ALARM, "Not finite");
+        return -1;
+    }
+
+    TRY {
+        epicsTimeStamp now;
+        if(epicsTimeGetCurrent(&now))
+            throw std::runtime_error("No time");
+        double time = now.secPastEpoch + POSIX_TIME_AT_EPICS_EPOCH + now.nsec*1e-9;
+
+        auto trend = pvt->trend;
+        Guard G(trend->lock);
+
+        if(trend->tiers.empty())
+            throw std::runtime_error("No tiers=");
+
+        trend->add(time, prec->val);
+
+        return 0;
+    } CATCH
+}
+
+long trendReadHist(aaiRecord *prec) noexcept
+{
+    TRY {
+        auto trend = pvt->trend;
+        Guard G(trend->lock);
+
+        if(pvt->tier >= trend->tiers.size())
+            throw std::runtime_error("tier= out of range");
+        auto& hist = trend->tiers[pvt->tier]->hist;
+
+        auto val = static_cast<double*>(prec->bptr);
+        // newest 'nelm' buckets, oldest first
+        size_t skip = hist.size() > prec->nelm ? hist.size() - prec->nelm : 0u;
+        epicsUInt32 n = 0u;
+        for(auto it = hist.begin()+skip; it!=hist.end(); ++it, n++) {
+            switch(pvt->stat) {
+            case TrendDev::Time: val[n] = it->time; break;
+            case TrendDev::Min: val[n] = it->min; break;
+            case TrendDev::Max: val[n] = it->max; break;
+            case TrendDev::Mean: val[n] = it->mean; break;
+            case TrendDev::Val: break; // rejected by trendInitRecordHist()
+            }
+        }
+        prec->nord = n;
+
+        return 0;
+    } CATCH
+}
+
+long trendSnapChanged(int detach, struct dbCommon *prec, IOSCANPVT* pscan) noexcept
+{
+    (void)detach;
+    auto pvt = static_cast<TrendDev*>(prec->dpvt);
+    if(!pvt)
+        return -1;
+
+    *pscan = pvt->trend->onSnap.scan;
+    return 0;
+}
+
+long trendTrigger(longoutRecord *prec) noexcept
+{
+    TRY {
+        epicsTimeStamp now;
+        if(epicsTimeGetCurrent(&now))
+            throw std::runtime_error("No time");
+        double time = now.secPastEpoch + POSIX_TIME_AT_EPICS_EPOCH + now.nsec*1e-9;
+
+        auto trend = pvt->trend;
+        Guard G(trend->lock);
+
+        trend->trigger(time);
+
+        return 0;
+    } CATCH
+}
+
+long trendReadSnap(aaiRecord *prec) noexcept
+{
+    TRY {
+        auto trend = pvt->trend;
+        Guard G(trend->lock);
+
+        auto val = static_cast<double*>(prec->bptr);
+        epicsUInt32 n = 0u;
+        for(; n<prec->nelm && n<trend->snap.size(); n++) {
+            auto& ent = trend->snap[n];
+            val[n] = pvt->stat==TrendDev::Time ? ent.time : ent.val;
+        }
+        prec->nord = n;
+
+        return 0;
+    } CATCH
+}
+
+aodset devTrendSample = {
+    {5, nullptr, nullptr, trendInitRecord, nullptr},
+    trendSample, nullptr,
+};
+aaidset devTrendHist = {
+    {5, nullptr, nullptr, trendInitRecordHist, trendChanged},
+    trendReadHist,
+};
+longoutdset devTrendTrigger = {
+    {5, nullptr, nullptr, trendInitRecord, nullptr},
+    trendTrigger,
+};
+aaidset devTrendSnapshot = {
+    {5, nullptr, nullptr, trendInitRecordSnap, trendSnapChanged},
+    trendReadSnap,
+};
+
+} // namespace
+
+extern "C" {
+epicsExportAddress(dset, devTrendSample);
+epicsExportAddress(dset, devTrendHist);
+epicsExportAddress(dset, devTrendTrigger);
+epicsExportAddress(dset, devTrendSnapshot);
+}